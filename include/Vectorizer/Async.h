@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <string>
+#include "Vectorizer/Math.h"
+#include "Vectorizer/Options.h"
+#include "Vectorizer/Executor.h"
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    // Handle to a vectorization running on an executor. Cancelling is cooperative: marching,
+    // linking and simplification poll the flag and stop early, and the result is then empty.
+    class VectorizeHandle
+    {
+    public:
+        VectorizeHandle() = default;
+        VectorizeHandle(std::future<List<Math::Chain>> future, shared<std::atomic<bool>> cancelFlag)
+            : future(std::move(future)), cancelFlag(std::move(cancelFlag)) {}
+
+        bool valid() const { return future.valid(); }
+        void cancel() { if (cancelFlag) cancelFlag->store(true); }
+        bool isCancelled() const { return cancelFlag && cancelFlag->load(); }
+
+        bool ready() const { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+        void wait() const { future.wait(); }
+
+        template<typename Rep, typename Period>
+        bool waitFor(const std::chrono::duration<Rep, Period>& timeout) const
+        {
+            return future.wait_for(timeout) == std::future_status::ready;
+        }
+
+        // Blocks until the work is done; can only be called once.
+        List<Math::Chain> get() { return future.get(); }
+
+    private:
+        std::future<List<Math::Chain>> future;
+        shared<std::atomic<bool>> cancelFlag;
+    };
+
+    // Runs vectorizeImage on the executor (defaultExecutor() when null) without blocking the caller.
+    VectorizeHandle vectorizeImageAsync(const std::string& path, const Options& options, Executor* executor = nullptr);
+
+    enum class Quality { Coarse, Final };
+
+    // Called on an executor thread, once per quality level that becomes available.
+    using ProgressCallback = std::function<void(Quality quality, const List<Math::Chain>& chains)>;
+
+    // Like vectorizeImageAsync, but delivers a quick result from a downsampled mask first
+    // (see Options::progressive) and the full-resolution chains afterwards. The coarse level
+    // is skipped when the final result comes straight from a cache. The handle yields the
+    // final chains.
+    VectorizeHandle vectorizeImageProgressive(const std::string& path, const Options& options, ProgressCallback callback, Executor* executor = nullptr);
+}
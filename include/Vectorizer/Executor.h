@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+
+namespace Vectorizer
+{
+    // Where the library runs its parallel work: marching bands, chain simplification, batch
+    // and pipeline stages, and async jobs. Implement it on top of an engine job system to
+    // keep the library from spawning its own threads.
+    //
+    // submit may run the task on any thread, at any later time. The library never blocks a
+    // task waiting on another submitted task that hasn't started: loops that fan out also
+    // run iterations on the submitting thread.
+    class Executor
+    {
+    public:
+        virtual ~Executor() = default;
+
+        virtual void submit(std::function<void()> task) = 0;
+
+        // Number of tasks that can usefully run at the same time.
+        virtual unsigned concurrency() const = 0;
+    };
+
+    // Executor used when none is passed explicitly. Initially the shared built-in ThreadPool;
+    // passing null restores it. The executor must outlive all work submitted to it.
+    void setDefaultExecutor(Executor* executor);
+    Executor& defaultExecutor();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include "Vectorizer/Math.h"
+#include "Vectorizer/Options.h"
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    struct ImageView;
+
+    // Resumable vectorization driven from the caller's thread, e.g. a few milliseconds per
+    // frame. Each step() marches, links and simplifies until its time budget is spent and
+    // then returns with all state kept. Decoding a file and simplifying a single chain are
+    // not split, so one step can overrun its budget by that much.
+    class VectorizeJob
+    {
+    public:
+        VectorizeJob(const std::string& path, const Options& options);
+        // The view's pixels must stay valid until the job is done.
+        VectorizeJob(const ImageView& image, const Options& options);
+        ~VectorizeJob();
+
+        VectorizeJob(const VectorizeJob&) = delete;
+        VectorizeJob& operator=(const VectorizeJob&) = delete;
+
+        // Works until the budget is used up or the job finishes; returns done().
+        bool step(std::chrono::microseconds budget);
+        bool done() const;
+
+        // Final chains, empty until done() (and empty if the image could not be loaded).
+        const List<Math::Chain>& results() const;
+
+    private:
+        struct State;
+        unique<State> state;
+    };
+}
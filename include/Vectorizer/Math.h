@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -45,5 +46,7 @@ namespace Vectorizer
         float pointsDistance(Point a, Point b);
 
         float pointToSegmentDistance(Segment segment, Point p);
+
+        float triangleArea(Point a, Point b, Point c);
     }
 }
\ No newline at end of file
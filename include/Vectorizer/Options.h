@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Vectorizer
+{
+    struct CacheOptions {
+        std::string directory;                          // empty disables the on-disk result cache
+        std::uintmax_t maxBytes = 256ull * 1024 * 1024; // oldest entries are evicted above this size
+    };
+
+    struct MaskCacheOptions {
+        bool enabled = false;      // reuse decoded masks across calls on the same unmodified file
+        bool keepRawChains = true; // also reuse the unsimplified chains, skipping marching and linking
+    };
+
+    struct ParallelOptions {
+        size_t minSplitPixels = 1024 * 1024; // smaller images are processed by a single task
+        int bandRows = 128;                  // cell rows marched per task when an image is split
+    };
+
+    // Batch runs over paths can read their files ahead in groups of queueDepth, through
+    // io_uring on Linux or pread on the pool elsewhere, and decode them from memory.
+    struct IoOptions {
+        bool batchedReads = false;
+        unsigned queueDepth = 32;
+    };
+
+    // Batch runs over paths can overlap decoding of the next images with tracing of the
+    // current ones. Each stage has its own concurrency limit on the shared pool, and at
+    // most queueCapacity finished items wait between two stages. With io.batchedReads the
+    // files read ahead may exceed that, up to one group of io.queueDepth.
+    struct PipelineOptions {
+        bool enabled = false;
+        unsigned decodeTasks = 2;
+        unsigned extractTasks = 0; // 0 uses the pool thread count
+        unsigned simplifyTasks = 2;
+        size_t queueCapacity = 8;
+    };
+
+    // Progressive mode first vectorizes a mask shrunk by coarseFactor with a loose tolerance,
+    // then the full-resolution image. coarseTolerance is in source pixels; 0 scales the
+    // regular tolerance by coarseFactor.
+    struct ProgressiveOptions {
+        int coarseFactor = 4;
+        float coarseTolerance = 0.0f;
+    };
+
+    // RamerDouglasPeucker keeps every vertex farther than tolerance from the simplified line.
+    // VisvalingamWhyatt drops vertices whose triangle with their neighbours has an area below
+    // tolerance squared; it runs in O(n log n) even on noisy outlines. ReumannWitkam is a
+    // single streaming pass run while chains are traced, for the lowest latency at the cost
+    // of a few more vertices. ImaiIri finds the fewest vertices within tolerance; it is much
+    // slower and meant for baking levels offline.
+    enum class SimplifyMethod {
+        RamerDouglasPeucker,
+        VisvalingamWhyatt,
+        ReumannWitkam,
+        ImaiIri
+    };
+
+    // closedLoops simplifies chains that end where they start as loops: between two far-apart
+    // anchors (or as a ring) rather than from the seam where tracing happened to begin.
+    // With ReumannWitkam this moves simplification out of tracing into its own pass.
+    // The vertex limits are applied after the tolerance pass by dropping the least important
+    // vertices first; 0 means unlimited.
+    // preserveTopology replaces the method with a Ramer-Douglas-Peucker pass that rejects any
+    // shortcut crossing another segment or cutting off another vertex, so chains never
+    // self-intersect or cross each other and every chain stays on its side of the others.
+    struct SimplifyOptions {
+        SimplifyMethod method = SimplifyMethod::RamerDouglasPeucker;
+        bool closedLoops = false;
+        bool preserveTopology = false;
+        size_t maxVerticesPerChain = 0;
+        size_t maxVerticesPerImage = 0;
+    };
+
+    // Drops small contours as soon as tracing closes them, before they are converted or
+    // simplified. minPoints counts traced points (the default drops traces of 20 or fewer).
+    // minArea is the enclosed area in source pixels squared, and minSize drops contours whose
+    // bounding box is narrower than it on both sides. maxChains keeps only the contours with
+    // the largest areas; 0 keeps all.
+    struct FilterOptions {
+        size_t minPoints = 21;
+        float minArea = 0.0f;
+        float minSize = 0.0f;
+        size_t maxChains = 0;
+    };
+
+    // Labels the 4-connected solid regions of the mask in parallel and traces each one as its
+    // own task. Regions covering fewer than minPixels mask pixels are dropped before tracing.
+    struct ComponentOptions {
+        bool enabled = false;
+        size_t minPixels = 0;
+    };
+
+    struct Options {
+        float tolerance = 1.0f;
+        int downsampleFactor = 1; // box filters factor x factor pixel blocks (at most 255) while thresholding; chains stay in source pixels
+        CacheOptions cache;
+        MaskCacheOptions maskCache;
+        ParallelOptions parallel;
+        PipelineOptions pipeline;
+        IoOptions io;
+        ProgressiveOptions progressive;
+        SimplifyOptions simplify;
+        ComponentOptions components;
+        FilterOptions filter;
+    };
+}
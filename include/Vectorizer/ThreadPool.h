@@ -0,0 +1,31 @@
+#pragma once
+
+#include <functional>
+#include "Vectorizer/Executor.h"
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    // Built-in work-stealing Executor. Every worker owns a task deque: tasks submitted from
+    // a worker go to its own deque, idle workers steal from the others.
+    class ThreadPool : public Executor
+    {
+    public:
+        explicit ThreadPool(unsigned threadCount = 0); // 0 uses the hardware concurrency
+        ~ThreadPool() override;
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void submit(std::function<void()> task) override;
+        unsigned concurrency() const override;
+        unsigned threadCount() const;
+
+        // Library-owned pool, the default executor unless setDefaultExecutor replaced it.
+        static ThreadPool& shared();
+
+    private:
+        struct Impl;
+        unique<Impl> impl;
+    };
+}
@@ -1,9 +1,75 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include "Vectorizer/Async.h"
+#include "Vectorizer/Executor.h"
+#include "Vectorizer/Job.h"
 #include "Vectorizer/Math.h"
+#include "Vectorizer/Options.h"
+#include "Vectorizer/ThreadPool.h"
 #include "Vectorizer/Util.h"
 
 namespace Vectorizer {
+	struct CacheStats {
+		std::uint64_t hits = 0;
+		std::uint64_t misses = 0;
+		std::uint64_t evictions = 0;
+	};
+
+	struct StageStats {
+		size_t items = 0;
+		unsigned tasks = 0;        // concurrency limit the stage ran with
+		double busySeconds = 0.0;  // summed over all of the stage's tasks
+		double utilization = 0.0;  // busySeconds / (wall time * tasks)
+		size_t maxQueued = 0;      // deepest the stage's input queue got
+	};
+
+	struct BatchStats {
+		double wallSeconds = 0.0;
+		StageStats read, decode, extract, simplify; // read only runs with io.batchedReads
+	};
+
+	// Pixels already in memory, row-major with no padding; the first channel is thresholded.
+	struct ImageView {
+		const unsigned char* data = nullptr;
+		int width = 0, height = 0, channels = 1;
+	};
+
+	// A traced outline. Closed contours don't repeat their first point at the end.
+	// parent indexes the innermost closed contour around this one (-1 at the top level) and
+	// depth counts those ancestors; odd depths are holes. Closed outlines run counter-clockwise
+	// on screen (with y pointing down) and holes clockwise. component numbers the solid
+	// islands: an outline and its holes share one, e.g. one physics body per component.
+	struct Contour {
+		Math::Chain points;
+		bool closed = false;
+		int parent = -1;
+		int depth = 0;
+		int component = -1;
+	};
+
 	List<Math::Chain> vectorizeImage(std::string path, float tolerance);
+	// With an executor, images of at least parallel.minSplitPixels are marched in bands and
+	// simplified in parallel on it; otherwise everything runs on the calling thread.
+	List<Math::Chain> vectorizeImage(const std::string& path, const Options& options, Executor* executor = nullptr);
+	List<Math::Chain> vectorizeImage(const ImageView& image, const Options& options, Executor* executor = nullptr);
+
+	// Same as vectorizeImage, with each chain that ends where it starts reported as closed
+	// and the closed ones nested into a containment tree.
+	List<Contour> vectorizeContours(const std::string& path, const Options& options, Executor* executor = nullptr);
+	List<Contour> vectorizeContours(const ImageView& image, const Options& options, Executor* executor = nullptr);
+
+	// Vectorizes every input on the executor (defaultExecutor() when null). Small images are
+	// grouped into one task, large ones are split into bands; results keep the input order.
+	// With options.pipeline enabled, paths run through bounded decode/extract/simplify stages
+	// and per-stage utilization is reported through stats.
+	List<List<Math::Chain>> vectorizeImages(const List<std::string>& paths, const Options& options, Executor* executor = nullptr, BatchStats* stats = nullptr);
+	List<List<Math::Chain>> vectorizeImages(const List<ImageView>& images, const Options& options, Executor* executor = nullptr);
+
+	CacheStats getResultCacheStats();
+
+	void setMaskCacheBudget(size_t bytes);
+	void clearMaskCache();
+	CacheStats getMaskCacheStats();
 }
@@ -0,0 +1,28 @@
+#include "Core/ImagePipeline.h"
+#include "Vectorizer/Async.h"
+
+namespace Vectorizer
+{
+    VectorizeHandle vectorizeImageAsync(const std::string& path, const Options& options, Executor* executor)
+    {
+        Executor& pool = executor ? *executor : defaultExecutor();
+        auto cancelFlag = std::make_shared<std::atomic<bool>>(false);
+        auto promise = std::make_shared<std::promise<List<Math::Chain>>>();
+        VectorizeHandle handle(promise->get_future(), cancelFlag);
+
+        pool.submit([path, options, cancelFlag, promise, &pool]() {
+            ImageJob job;
+            job.path = path;
+            job.cancel = cancelFlag.get();
+            try
+            {
+                promise->set_value(vectorizeJob(job, options, &pool));
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+        });
+        return handle;
+    }
+}
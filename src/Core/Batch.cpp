@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <filesystem>
+#include "Core/BatchPipeline.h"
+#include "Core/ImagePipeline.h"
+#include "Core/Parallel.h"
+#include "IO/FileReader.h"
+
+namespace Vectorizer
+{
+    using IndexRange = std::pair<size_t, size_t>;
+
+    // Groups consecutive inputs into tasks of roughly equal estimated cost. Inputs that are
+    // expensive on their own get a task each and are split further inside the pipeline.
+    static List<IndexRange> makeBatches(const List<size_t>& costs, unsigned concurrency)
+    {
+        size_t totalCost = 0;
+        for (size_t cost : costs)
+        {
+            totalCost += cost;
+        }
+        const size_t targetCost = std::max<size_t>(1, totalCost / (static_cast<size_t>(concurrency) * 8));
+
+        List<IndexRange> batches;
+        size_t begin = 0, batchCost = 0;
+        for (size_t i = 0; i < costs.size(); ++i)
+        {
+            batchCost += costs[i];
+            if (batchCost >= targetCost)
+            {
+                batches.push_back({ begin, i + 1 });
+                begin = i + 1;
+                batchCost = 0;
+            }
+        }
+        if (begin < costs.size())
+        {
+            batches.push_back({ begin, costs.size() });
+        }
+        return batches;
+    }
+
+    template<typename Process>
+    static void runBatches(Executor& pool, const List<size_t>& costs, Process&& process)
+    {
+        List<IndexRange> batches = makeBatches(costs, pool.concurrency());
+        parallelFor(&pool, batches.size(), [&](size_t batch) {
+            process(batches[batch].first, batches[batch].second);
+        });
+    }
+
+    List<List<Math::Chain>> vectorizeImages(const List<std::string>& paths, const Options& options, Executor* pool, BatchStats* stats)
+    {
+        Executor& executor = pool ? *pool : defaultExecutor();
+        if (options.pipeline.enabled)
+        {
+            return runBatchPipeline(paths, options, executor, stats);
+        }
+
+        // The compressed file size is a cheap stand-in for the decode and marching cost.
+        List<size_t> costs(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            std::error_code error;
+            auto size = std::filesystem::file_size(paths[i], error);
+            costs[i] = error ? 1 : static_cast<size_t>(size);
+        }
+
+        List<List<Math::Chain>> results(paths.size());
+        runBatches(executor, costs, [&](size_t begin, size_t end) {
+            List<List<unsigned char>> fileBytes;
+            if (options.io.batchedReads)
+            {
+                List<std::string> batchPaths(paths.begin() + begin, paths.begin() + end);
+                fileBytes = FileReader::readFiles(batchPaths, options.io.queueDepth, &executor);
+            }
+            for (size_t i = begin; i < end; ++i)
+            {
+                ImageJob job;
+                job.path = paths[i];
+                if (!fileBytes.empty())
+                {
+                    job.fileBytes = std::move(fileBytes[i - begin]);
+                }
+                results[i] = vectorizeJob(job, options, &executor);
+            }
+        });
+        return results;
+    }
+
+    List<List<Math::Chain>> vectorizeImages(const List<ImageView>& images, const Options& options, Executor* pool)
+    {
+        Executor& executor = pool ? *pool : defaultExecutor();
+
+        List<size_t> costs(images.size());
+        for (size_t i = 0; i < images.size(); ++i)
+        {
+            costs[i] = std::max<size_t>(1, static_cast<size_t>(std::max(images[i].width, 0)) * std::max(images[i].height, 0));
+        }
+
+        List<List<Math::Chain>> results(images.size());
+        runBatches(executor, costs, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                results[i] = vectorizeView(images[i], options, &executor);
+            }
+        });
+        return results;
+    }
+}
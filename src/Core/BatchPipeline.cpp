@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "Core/BatchPipeline.h"
+#include "Core/ImagePipeline.h"
+#include "IO/FileReader.h"
+
+namespace Vectorizer
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        enum Stage { ReadStage, DecodeStage, ExtractStage, SimplifyStage, StageCount };
+
+        struct StageState {
+            unsigned limit = 1;
+            unsigned running = 0;  // tasks
+            size_t inFlight = 0;   // items held by running tasks
+            size_t batchSize = 1;  // items taken per task
+            std::deque<size_t> queue;
+            StageStats stats;
+        };
+
+        struct Work {
+            Stage stage;
+            List<size_t> items;
+        };
+
+        // Shared with its pool tasks: a task that only starts after run() returned finds no
+        // work left and must still find the object alive.
+        class BatchPipeline : public std::enable_shared_from_this<BatchPipeline>
+        {
+        public:
+            BatchPipeline(const List<std::string>& paths, const Options& options, Executor& pool)
+                : options(options), pool(pool), jobs(paths.size())
+            {
+                const PipelineOptions& pipeline = options.pipeline;
+                stages[ReadStage].batchSize = std::max(1u, options.io.queueDepth);
+                stages[DecodeStage].limit = std::max(1u, pipeline.decodeTasks);
+                stages[ExtractStage].limit = std::max(1u, pipeline.extractTasks ? pipeline.extractTasks : pool.concurrency());
+                stages[SimplifyStage].limit = std::max(1u, pipeline.simplifyTasks);
+                capacity = std::max<size_t>(1, pipeline.queueCapacity);
+
+                // Without batched reads the decode stage opens its files itself.
+                firstStage = options.io.batchedReads ? ReadStage : DecodeStage;
+                for (size_t i = 0; i < paths.size(); ++i)
+                {
+                    jobs[i].path = paths[i];
+                    stages[firstStage].queue.push_back(i);
+                }
+                stages[firstStage].stats.maxQueued = paths.size();
+            }
+
+            List<List<Math::Chain>> run(BatchStats* stats)
+            {
+                Clock::time_point start = Clock::now();
+                {
+                    // The calling thread runs stage work too, so the batch also finishes when
+                    // called from inside a task of a busy (or single-threaded) pool.
+                    std::unique_lock<std::mutex> lock(mutex);
+                    pump();
+                    while (doneCount < jobs.size())
+                    {
+                        if (ready.empty())
+                        {
+                            changed.wait(lock);
+                            continue;
+                        }
+                        Work work = std::move(ready.front());
+                        ready.pop_front();
+                        lock.unlock();
+                        execute(work.stage, work.items);
+                        lock.lock();
+                    }
+                }
+                double wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+                if (stats)
+                {
+                    stats->wallSeconds = wallSeconds;
+                    StageStats* outStages[StageCount] = { &stats->read, &stats->decode, &stats->extract, &stats->simplify };
+                    for (int stage = firstStage; stage < StageCount; ++stage)
+                    {
+                        StageStats& stageStats = stages[stage].stats;
+                        stageStats.tasks = stages[stage].limit;
+                        stageStats.utilization = wallSeconds > 0.0 ? stageStats.busySeconds / (wallSeconds * stageStats.tasks) : 0.0;
+                        *outStages[stage] = stageStats;
+                    }
+                }
+
+                List<List<Math::Chain>> results(jobs.size());
+                for (size_t i = 0; i < jobs.size(); ++i)
+                {
+                    results[i] = std::move(jobs[i].chains);
+                }
+                return results;
+            }
+
+        private:
+            // Queues every item that is allowed to run, with one pool task per unit of work; the
+            // unit goes to whichever thread gets to it first. Later stages go first so finished
+            // work drains before new images are decoded. Callers hold the mutex.
+            void pump()
+            {
+                for (int stage = StageCount - 1; stage >= 0; --stage)
+                {
+                    StageState& state = stages[stage];
+                    while (state.running < state.limit && !state.queue.empty())
+                    {
+                        size_t take = std::min(state.batchSize, state.queue.size());
+                        // Backpressure: results of running tasks must fit in the next queue.
+                        // Read results are only file bytes, so a full group of queueDepth
+                        // reads may wait for decoding even above queueCapacity.
+                        if (stage + 1 < StageCount)
+                        {
+                            size_t limit = stage == ReadStage ? std::max(capacity, state.batchSize) : capacity;
+                            size_t committed = stages[stage + 1].queue.size() + state.inFlight;
+                            take = committed < limit ? std::min(take, limit - committed) : 0;
+                        }
+                        if (take == 0)
+                        {
+                            break;
+                        }
+                        List<size_t> items(state.queue.begin(), state.queue.begin() + take);
+                        state.queue.erase(state.queue.begin(), state.queue.begin() + take);
+                        state.running++;
+                        state.inFlight += take;
+                        ready.push_back({ static_cast<Stage>(stage), std::move(items) });
+                        pool.submit([self = shared_from_this()] { self->runReady(); });
+                        changed.notify_all();
+                    }
+                }
+            }
+
+            void runReady()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (ready.empty())
+                {
+                    return;
+                }
+                Work work = std::move(ready.front());
+                ready.pop_front();
+                lock.unlock();
+                execute(work.stage, work.items);
+            }
+
+            void readFiles(const List<size_t>& items)
+            {
+                List<std::string> paths;
+                for (size_t item : items)
+                {
+                    paths.push_back(jobs[item].path);
+                }
+                List<List<unsigned char>> files = FileReader::readFiles(paths, options.io.queueDepth, &pool);
+                for (size_t i = 0; i < items.size(); ++i)
+                {
+                    jobs[items[i]].fileBytes = std::move(files[i]);
+                }
+            }
+
+            void execute(Stage stage, const List<size_t>& items)
+            {
+                Clock::time_point start = Clock::now();
+                if (stage == ReadStage)
+                {
+                    readFiles(items);
+                }
+                for (size_t item : items)
+                {
+                    ImageJob& job = jobs[item];
+                    switch (stage)
+                    {
+                    case DecodeStage: decodeStage(job, options); break;
+                    case ExtractStage: extractStage(job, options, &pool); break;
+                    case SimplifyStage: simplifyStage(job, options, &pool); break;
+                    default: break;
+                    }
+                }
+                double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                StageState& state = stages[stage];
+                state.running--;
+                state.inFlight -= items.size();
+                state.stats.items += items.size();
+                state.stats.busySeconds += seconds;
+                for (size_t item : items)
+                {
+                    if (jobs[item].finished)
+                    {
+                        doneCount++;
+                        continue;
+                    }
+                    StageState& next = stages[stage + 1];
+                    next.queue.push_back(item);
+                    next.stats.maxQueued = std::max(next.stats.maxQueued, next.queue.size());
+                }
+                pump();
+                if (doneCount == jobs.size())
+                {
+                    changed.notify_all();
+                }
+            }
+
+            const Options& options;
+            Executor& pool;
+            List<ImageJob> jobs;
+            StageState stages[StageCount];
+            Stage firstStage = DecodeStage;
+            size_t capacity = 1;
+            size_t doneCount = 0;
+            std::deque<Work> ready;
+            std::mutex mutex;
+            std::condition_variable changed; // new ready work or the last item done
+        };
+    }
+
+    List<List<Math::Chain>> runBatchPipeline(const List<std::string>& paths, const Options& options, Executor& pool, BatchStats* stats)
+    {
+        auto pipeline = std::make_shared<BatchPipeline>(paths, options, pool);
+        return pipeline->run(stats);
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Vectorizer/Vectorizer.h"
+
+namespace Vectorizer
+{
+    // Runs paths through decode -> extract -> simplify with a concurrency limit per stage and
+    // bounded queues in between. Stage tasks never block: finishing one schedules whatever
+    // became runnable, so image N + 1 is decoded while image N is traced.
+    List<List<Math::Chain>> runBatchPipeline(const List<std::string>& paths, const Options& options, Executor& pool, BatchStats* stats);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Vectorizer
+{
+    namespace Bits
+    {
+        // word must be non-zero.
+        inline int countTrailingZeros(std::uint64_t word)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, word);
+            return static_cast<int>(index);
+#else
+            return __builtin_ctzll(word);
+#endif
+        }
+
+        inline int popCount(std::uint64_t word)
+        {
+#if defined(_MSC_VER)
+            return static_cast<int>(__popcnt64(word));
+#else
+            return __builtin_popcountll(word);
+#endif
+        }
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <atomic>
+
+namespace Vectorizer
+{
+    // Cooperative cancellation: long loops poll the flag and bail out early. A null flag
+    // means the work can't be cancelled.
+    using CancelFlag = std::atomic<bool>;
+
+    inline bool isCancelled(const CancelFlag* cancel)
+    {
+        return cancel && cancel->load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "Core/ChainBuilder.h"
+#include "Core/Simplify.h"
+
+namespace Vectorizer
+{
+    static constexpr size_t linksPerCancelCheck = 256;
+
+    ChainLinker::ChainLinker(List<LatticeSegment> segments, float streamTolerance, const ChainFilter& filter)
+        : segments(std::move(segments)), streamTolerance(streamTolerance), filter(filter)
+    {
+        // Every lattice point starts at most one segment, so the next link is a single lookup.
+        used.assign(this->segments.size(), false);
+        segmentByStart.reserve(this->segments.size());
+        for (size_t i = 0; i < this->segments.size(); ++i)
+        {
+            segmentByStart.emplace(latticeKey(this->segments[i].start), i);
+        }
+        remaining = this->segments.size();
+        nextUnused = this->segments.size();
+    }
+
+    void ChainLinker::useSegment(size_t index)
+    {
+        used[index] = true;
+        auto entry = segmentByStart.find(latticeKey(segments[index].start));
+        if (entry != segmentByStart.end() && entry->second == index)
+        {
+            segmentByStart.erase(entry);
+        }
+        remaining--;
+    }
+
+    // Visits the vertices that aren't in the middle of a straight run. Lattice coordinates make
+    // the collinearity test exact, so the chain keeps its shape with zero error; most traced
+    // vertices sit on axis-aligned or 45 degree runs, which leaves RDP far fewer points to scan.
+    template<typename Visitor>
+    static void forEachCorner(const List<LatticePoint>& chain, Visitor&& visit)
+    {
+        visit(toPoint(chain.front()));
+        for (size_t i = 1; i + 1 < chain.size(); ++i)
+        {
+            const std::int64_t inX = chain[i].x2 - chain[i - 1].x2, inY = chain[i].y2 - chain[i - 1].y2;
+            const std::int64_t outX = chain[i + 1].x2 - chain[i].x2, outY = chain[i + 1].y2 - chain[i].y2;
+            const bool straight = inX * outY == inY * outX && inX * outX + inY * outY > 0;
+            if (!straight)
+            {
+                visit(toPoint(chain[i]));
+            }
+        }
+        visit(toPoint(chain.back()));
+    }
+
+    void ChainLinker::startChain(const LatticeSegment& first)
+    {
+        chain = { first.start };
+        doubledArea = 0;
+        minX2 = maxX2 = first.start.x2;
+        minY2 = maxY2 = first.start.y2;
+        extendChain(first.end);
+    }
+
+    void ChainLinker::extendChain(const LatticePoint& point)
+    {
+        const LatticePoint& last = chain.back();
+        doubledArea += static_cast<std::int64_t>(last.x2) * point.y2 - static_cast<std::int64_t>(point.x2) * last.y2;
+        minX2 = std::min(minX2, point.x2);
+        maxX2 = std::max(maxX2, point.x2);
+        minY2 = std::min(minY2, point.y2);
+        maxY2 = std::max(maxY2, point.y2);
+        chain.push_back(point);
+    }
+
+    bool ChainLinker::keepsChain() const
+    {
+        if (chain.size() < filter.minPoints)
+        {
+            return false;
+        }
+        // Closing edge back to the first point; zero for closed chains.
+        const LatticePoint& first = chain.front();
+        const LatticePoint& last = chain.back();
+        const std::int64_t closing = static_cast<std::int64_t>(last.x2) * first.y2 - static_cast<std::int64_t>(first.x2) * last.y2;
+        if (static_cast<double>(std::llabs(doubledArea + closing)) < 8.0 * filter.minArea)
+        {
+            return false;
+        }
+        const float minSize2 = 2.0f * filter.minSize;
+        return maxX2 - minX2 >= minSize2 || maxY2 - minY2 >= minSize2;
+    }
+
+    void ChainLinker::closeChain()
+    {
+        if (keepsChain()) {
+            Math::Chain points;
+            if (streamTolerance > 0.0f)
+            {
+                StreamingSimplifier simplifier(streamTolerance, points);
+                forEachCorner(chain, [&](const Math::Point& point) { simplifier.push(point); });
+                simplifier.finish();
+            }
+            else
+            {
+                forEachCorner(chain, [&](const Math::Point& point) { points.push_back(point); });
+            }
+            chains.push_back(std::move(points));
+        }
+        chain.clear();
+    }
+
+    bool ChainLinker::link(size_t maxLinks)
+    {
+        for (size_t links = 0; links < maxLinks; ++links)
+        {
+            if (chain.empty())
+            {
+                if (remaining <= 1)
+                {
+                    return true;
+                }
+                // New chains start from the last unused segment.
+                while (used[nextUnused - 1])
+                {
+                    nextUnused--;
+                }
+                startChain(segments[nextUnused - 1]);
+                useSegment(nextUnused - 1);
+            }
+
+            auto next = segmentByStart.find(latticeKey(chain.back()));
+            if (next != segmentByStart.end())
+            {
+                extendChain(segments[next->second].end);
+                useSegment(next->second);
+            }
+            else
+            {
+                closeChain();
+            }
+        }
+        return done();
+    }
+
+    bool ChainLinker::done() const
+    {
+        return chain.empty() && remaining <= 1;
+    }
+
+    List<Math::Chain> ChainLinker::takeChains()
+    {
+        return std::move(chains);
+    }
+
+    List<Math::Chain> buildChainsFromSegments(List<LatticeSegment>& segments, const CancelFlag* cancel, float streamTolerance, const ChainFilter& filter)
+    {
+        ChainLinker linker(std::move(segments), streamTolerance, filter);
+        segments.clear();
+        while (!linker.link(linksPerCancelCheck))
+        {
+            if (isCancelled(cancel))
+            {
+                return {};
+            }
+        }
+        return linker.takeChains();
+    }
+
+    void keepLargestChains(List<Math::Chain>& chains, size_t maxCount)
+    {
+        if (maxCount == 0 || chains.size() <= maxCount)
+        {
+            return;
+        }
+        List<double> areas(chains.size());
+        for (size_t i = 0; i < chains.size(); ++i)
+        {
+            const Math::Chain& chain = chains[i];
+            double area = 0.0;
+            for (size_t k = 0, j = chain.size() - 1; k < chain.size(); j = k++)
+            {
+                area += static_cast<double>(chain[j].x) * chain[k].y - static_cast<double>(chain[k].x) * chain[j].y;
+            }
+            areas[i] = std::fabs(area);
+        }
+        List<size_t> order(chains.size());
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            order[i] = i;
+        }
+        std::nth_element(order.begin(), order.begin() + maxCount, order.end(), [&](size_t a, size_t b) {
+            return areas[a] != areas[b] ? areas[a] > areas[b] : a < b;
+        });
+        order.resize(maxCount);
+        std::sort(order.begin(), order.end());
+
+        List<Math::Chain> kept;
+        kept.reserve(maxCount);
+        for (size_t i : order)
+        {
+            kept.push_back(std::move(chains[i]));
+        }
+        chains = std::move(kept);
+    }
+}
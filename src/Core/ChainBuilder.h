@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include "Core/Cancel.h"
+#include "Core/Lattice.h"
+#include "Vectorizer/Math.h"
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    // What a chain must reach when it closes to be kept, in mask pixels. Area and bounds are
+    // accumulated while the chain is traced, so rejected chains are never converted.
+    struct ChainFilter {
+        size_t minPoints = 21;
+        float minArea = 0.0f; // enclosed area
+        float minSize = 0.0f; // chains with both bounding box sides below it are dropped
+    };
+
+    // Links segments end to start into chains. Work is done in bounded slices so callers can
+    // interleave it with deadline or cancellation checks; all state survives between slices.
+    class ChainLinker
+    {
+    public:
+        // A positive streamTolerance runs kept chains through a StreamingSimplifier as they close.
+        explicit ChainLinker(List<LatticeSegment> segments, float streamTolerance = 0.0f, const ChainFilter& filter = {});
+
+        // Appends up to maxLinks segments to chains; returns true once every segment is used.
+        bool link(size_t maxLinks);
+        bool done() const;
+
+        // Chains come out with the inner vertices of straight runs removed.
+        List<Math::Chain> takeChains();
+
+    private:
+        void startChain(const LatticeSegment& first);
+        void extendChain(const LatticePoint& point);
+        bool keepsChain() const;
+        void closeChain();
+        void useSegment(size_t index);
+
+        List<LatticeSegment> segments;
+        List<bool> used;
+        Dictionary<std::uint64_t, size_t, LatticeKeyHash> segmentByStart;
+        size_t remaining = 0;
+        size_t nextUnused = 0;  // one past the last segment that may still be unused
+        float streamTolerance = 0.0f;
+        ChainFilter filter;
+        List<LatticePoint> chain;
+        std::int64_t doubledArea = 0; // shoelace sum in lattice units, eight times the area
+        std::int32_t minX2 = 0, minY2 = 0, maxX2 = 0, maxY2 = 0;
+        List<Math::Chain> chains;
+    };
+
+    // Links segments end to start into chains, consuming the segment list.
+    List<Math::Chain> buildChainsFromSegments(List<LatticeSegment>& segments, const CancelFlag* cancel = nullptr, float streamTolerance = 0.0f, const ChainFilter& filter = {});
+
+    // Keeps the maxCount chains enclosing the largest areas, in their original order. 0 keeps all.
+    void keepLargestChains(List<Math::Chain>& chains, size_t maxCount);
+}
@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <iterator>
+#include "Core/Bits.h"
+#include "Core/ChainBuilder.h"
+#include "Core/Components.h"
+#include "Core/MarchingSquares.h"
+#include "Core/Parallel.h"
+
+namespace Vectorizer
+{
+    // While labeling, labels holds union-find parents as pixel indices. A parent always has
+    // a smaller index than its child, so the root of a component is its first pixel.
+    static constexpr std::uint32_t emptyPixel = 0xFFFFFFFFu;
+
+    // Path halving is only safe inside a band: across bands it could hang an inner pixel
+    // directly under another band, which the per-band flattening can't follow.
+    static std::uint32_t findRoot(List<std::uint32_t>& parents, std::uint32_t pixel, bool compress)
+    {
+        while (parents[pixel] != pixel)
+        {
+            if (compress)
+            {
+                parents[pixel] = parents[parents[pixel]];
+            }
+            pixel = parents[pixel];
+        }
+        return pixel;
+    }
+
+    // Returns the root that was hung under the other one, or emptyPixel when already joined.
+    static std::uint32_t unite(List<std::uint32_t>& parents, std::uint32_t a, std::uint32_t b, bool compress)
+    {
+        a = findRoot(parents, a, compress);
+        b = findRoot(parents, b, compress);
+        if (a == b)
+        {
+            return emptyPixel;
+        }
+        if (a > b)
+        {
+            std::swap(a, b);
+        }
+        parents[b] = a;
+        return b;
+    }
+
+    static void labelBand(const Mask& mask, List<std::uint32_t>& parents, int beginY, int endY)
+    {
+        const size_t width = static_cast<size_t>(mask.width);
+        std::fill(parents.begin() + beginY * width, parents.begin() + endY * width, emptyPixel);
+        for (int y = beginY; y < endY; ++y)
+        {
+            const std::uint64_t* row = mask.bits.data() + static_cast<size_t>(y) * mask.wordsPerRow;
+            for (int index = 0; index < mask.wordsPerRow; ++index)
+            {
+                for (std::uint64_t word = row[index]; word != 0; word &= word - 1)
+                {
+                    const int x = index * 64 + Bits::countTrailingZeros(word);
+                    const std::uint32_t pixel = static_cast<std::uint32_t>(y * width + x);
+                    parents[pixel] = pixel;
+                    if (x > 0 && parents[pixel - 1] != emptyPixel)
+                    {
+                        unite(parents, pixel, pixel - 1, true);
+                    }
+                    if (y > beginY && parents[pixel - width] != emptyPixel)
+                    {
+                        unite(parents, pixel, static_cast<std::uint32_t>(pixel - width), true);
+                    }
+                }
+            }
+        }
+    }
+
+    Components labelComponents(const Mask& mask, Executor* pool, int bandRows)
+    {
+        Components result;
+        result.width = mask.width;
+        result.height = mask.height;
+        const size_t width = static_cast<size_t>(mask.width);
+        List<std::uint32_t>& labels = result.labels;
+        labels.resize(width * mask.height);
+
+        bandRows = std::max(1, bandRows);
+        const int bandCount = (mask.height + bandRows - 1) / bandRows;
+        auto bandBegin = [&](int band) { return band * bandRows; };
+        auto bandEnd = [&](int band) { return std::min(mask.height, (band + 1) * bandRows); };
+
+        parallelFor(pool, bandCount, [&](size_t band) {
+            labelBand(mask, labels, bandBegin(static_cast<int>(band)), bandEnd(static_cast<int>(band)));
+        });
+
+        // Merge across band edges, then point every root that moved straight at its final root,
+        // so the flattening below never has to look outside its own band.
+        List<std::uint32_t> movedRoots;
+        for (int band = 1; band < bandCount; ++band)
+        {
+            const size_t first = static_cast<size_t>(bandBegin(band)) * width;
+            for (size_t pixel = first; pixel < first + width; ++pixel)
+            {
+                if (labels[pixel] != emptyPixel && labels[pixel - width] != emptyPixel)
+                {
+                    const std::uint32_t moved = unite(labels, static_cast<std::uint32_t>(pixel), static_cast<std::uint32_t>(pixel - width), false);
+                    if (moved != emptyPixel)
+                    {
+                        movedRoots.push_back(moved);
+                    }
+                }
+            }
+        }
+        for (std::uint32_t root : movedRoots)
+        {
+            labels[root] = findRoot(labels, root, false);
+        }
+
+        // Parents precede their children, so one ascending pass per band flattens it.
+        List<List<std::uint32_t>> bandRoots(bandCount);
+        parallelFor(pool, bandCount, [&](size_t band) {
+            const size_t first = static_cast<size_t>(bandBegin(static_cast<int>(band))) * width;
+            const size_t last = static_cast<size_t>(bandEnd(static_cast<int>(band))) * width;
+            for (size_t pixel = first; pixel < last; ++pixel)
+            {
+                const std::uint32_t parent = labels[pixel];
+                if (parent == emptyPixel)
+                {
+                    continue;
+                }
+                if (parent == pixel)
+                {
+                    bandRoots[band].push_back(parent);
+                }
+                else if (parent >= first)
+                {
+                    labels[pixel] = labels[parent];
+                }
+            }
+        });
+
+        Dictionary<std::uint32_t, std::uint32_t> componentOfRoot;
+        for (const List<std::uint32_t>& roots : bandRoots)
+        {
+            for (std::uint32_t root : roots)
+            {
+                componentOfRoot.emplace(root, static_cast<std::uint32_t>(componentOfRoot.size()));
+            }
+        }
+
+        // Relabel to component numbers and gather bounds per band, then combine the bands.
+        List<Dictionary<std::uint32_t, ComponentInfo>> bandInfo(bandCount);
+        parallelFor(pool, bandCount, [&](size_t band) {
+            const int beginY = bandBegin(static_cast<int>(band)), endY = bandEnd(static_cast<int>(band));
+            // Neighbouring pixels mostly share a root, so lookups are done once per change.
+            std::uint32_t lastRoot = emptyPixel, component = 0;
+            ComponentInfo* info = nullptr;
+            for (int y = beginY; y < endY; ++y)
+            {
+                for (int x = 0; x < mask.width; ++x)
+                {
+                    std::uint32_t& label = labels[y * width + x];
+                    if (label == emptyPixel)
+                    {
+                        label = 0;
+                        continue;
+                    }
+                    if (label != lastRoot)
+                    {
+                        lastRoot = label;
+                        component = componentOfRoot.at(label);
+                        info = &bandInfo[band].try_emplace(component, ComponentInfo{ x, y, x, y, 0 }).first->second;
+                    }
+                    label = component + 1;
+                    info->minX = std::min(info->minX, x);
+                    info->maxX = std::max(info->maxX, x);
+                    info->maxY = y;
+                    info->pixels++;
+                }
+            }
+        });
+
+        result.info.resize(componentOfRoot.size());
+        List<bool> seen(result.info.size(), false);
+        for (const Dictionary<std::uint32_t, ComponentInfo>& infos : bandInfo)
+        {
+            for (const auto& entry : infos)
+            {
+                ComponentInfo& info = result.info[entry.first];
+                if (!seen[entry.first])
+                {
+                    info = entry.second;
+                    seen[entry.first] = true;
+                    continue;
+                }
+                info.minX = std::min(info.minX, entry.second.minX);
+                info.maxX = std::max(info.maxX, entry.second.maxX);
+                info.minY = std::min(info.minY, entry.second.minY);
+                info.maxY = std::max(info.maxY, entry.second.maxY);
+                info.pixels += entry.second.pixels;
+            }
+        }
+        return result;
+    }
+
+    List<Math::Chain> traceComponents(const Mask& mask, const Components& components, size_t minPixels, const ChainFilter& filter, float streamTolerance, Executor* pool, const CancelFlag* cancel)
+    {
+        // Every contour of a component lies within its pixel bounds, which span exactly as
+        // far as its outline does.
+        List<std::uint32_t> kept;
+        for (size_t i = 0; i < components.info.size(); ++i)
+        {
+            const ComponentInfo& info = components.info[i];
+            const float width = static_cast<float>(info.maxX - info.minX + 1), height = static_cast<float>(info.maxY - info.minY + 1);
+            if (info.pixels >= minPixels && width * height >= filter.minArea && (width >= filter.minSize || height >= filter.minSize))
+            {
+                kept.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+
+        List<List<Math::Chain>> traced(kept.size());
+        parallelFor(pool, kept.size(), [&](size_t k) {
+            if (isCancelled(cancel))
+            {
+                return;
+            }
+            const std::uint32_t label = kept[k] + 1;
+            const ComponentInfo& info = components.info[kept[k]];
+            Mask single = allocateMask(info.maxX - info.minX + 1, info.maxY - info.minY + 1);
+            single.scale = mask.scale;
+            for (int y = info.minY; y <= info.maxY; ++y)
+            {
+                const std::uint32_t* row = components.labels.data() + static_cast<size_t>(y) * components.width;
+                for (int x = info.minX; x <= info.maxX; ++x)
+                {
+                    if (row[x] == label)
+                    {
+                        single.setSolid(x - info.minX, y - info.minY);
+                    }
+                }
+            }
+
+            List<LatticeSegment> segments = marchingSquares(single, nullptr, 0, cancel);
+            traced[k] = buildChainsFromSegments(segments, cancel, streamTolerance, filter);
+            const float offsetX = static_cast<float>(info.minX), offsetY = static_cast<float>(info.minY);
+            for (Math::Chain& chain : traced[k])
+            {
+                for (Math::Point& point : chain)
+                {
+                    point.x += offsetX;
+                    point.y += offsetY;
+                }
+            }
+        });
+
+        List<Math::Chain> chains;
+        for (List<Math::Chain>& group : traced)
+        {
+            std::move(group.begin(), group.end(), std::back_inserter(chains));
+        }
+        return chains;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include "Core/Cancel.h"
+#include "Core/ChainBuilder.h"
+#include "Core/Mask.h"
+#include "Vectorizer/Executor.h"
+#include "Vectorizer/Math.h"
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    struct ComponentInfo {
+        int minX = 0, minY = 0, maxX = 0, maxY = 0; // inclusive mask pixel bounds
+        size_t pixels = 0;
+    };
+
+    // The 4-connected solid regions of a mask, which is how marching squares separates
+    // diagonal pixels. labels holds 1 + the component index of each pixel and 0 for empty
+    // pixels; components are numbered in raster order of their first pixel.
+    struct Components {
+        int width = 0, height = 0;
+        List<std::uint32_t> labels;
+        List<ComponentInfo> info;
+    };
+
+    // Union-find labeling of bands of bandRows rows on the pool, then a merge across the band
+    // edges. Each band only ever writes its own pixels.
+    Components labelComponents(const Mask& mask, Executor* pool = nullptr, int bandRows = 128);
+
+    // Traces each component of at least minPixels pixels on a mask holding only that
+    // component, one task per component. Components whose bounding box already fails the
+    // filter's area or size are skipped untraced. The chains come back grouped by component,
+    // in label order, and in mask pixel coordinates.
+    List<Math::Chain> traceComponents(const Mask& mask, const Components& components, size_t minPixels, const ChainFilter& filter = {}, float streamTolerance = 0.0f, Executor* pool = nullptr, const CancelFlag* cancel = nullptr);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Vectorizer
+{
+    namespace Hash
+    {
+        inline std::uint64_t mix(std::uint64_t value)
+        {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdull;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53ull;
+            value ^= value >> 33;
+            return value;
+        }
+
+        inline std::uint64_t combine(std::uint64_t seed, std::uint64_t value)
+        {
+            return mix(seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)));
+        }
+
+        // Word-at-a-time hash, fast enough to run over whole image files on every call.
+        inline std::uint64_t bytes(const unsigned char* data, size_t size, std::uint64_t seed = 0)
+        {
+            std::uint64_t hash = seed ^ (size * 0x9e3779b97f4a7c15ull);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, data + i, 8);
+                hash = (hash ^ mix(word)) * 0x9fb21c651e98df25ull;
+            }
+            std::uint64_t tail = 0;
+            std::memcpy(&tail, data + i, size - i);
+            return mix(hash ^ mix(tail));
+        }
+
+        inline std::uint64_t floatBits(float value)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+    }
+}
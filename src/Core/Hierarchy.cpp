@@ -0,0 +1,166 @@
+#include <algorithm>
+#include "Core/Hierarchy.h"
+
+namespace Vectorizer
+{
+    namespace
+    {
+        struct Crossing {
+            float x;
+            int contour;
+            bool downward; // the boundary runs towards larger y here
+        };
+
+        struct Probe {
+            float y;      // between two vertex rows, so no vertex lies on it
+            float x = 0;  // leftmost crossing of the contour itself
+            size_t line;  // index into the sorted probe lines
+        };
+
+        // Twice the shoelace area in image coordinates; negative is counter-clockwise on screen.
+        double signedArea(const Math::Chain& points)
+        {
+            double area = 0.0;
+            for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++)
+            {
+                area += static_cast<double>(points[j].x) * points[i].y - static_cast<double>(points[i].x) * points[j].y;
+            }
+            return area;
+        }
+
+        template<typename Visit>
+        void forEachSegment(const Math::Chain& points, Visit&& visit)
+        {
+            for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++)
+            {
+                visit(points[j], points[i]);
+            }
+        }
+
+        float crossingX(const Math::Point& a, const Math::Point& b, float y)
+        {
+            return a.x + (b.x - a.x) * ((y - a.y) / (b.y - a.y));
+        }
+    }
+
+    void nestContours(List<Contour>& contours)
+    {
+        List<float> rows;
+        for (const Contour& contour : contours)
+        {
+            if (contour.closed)
+            {
+                for (const Math::Point& point : contour.points)
+                {
+                    rows.push_back(point.y);
+                }
+            }
+        }
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+        // Each closed contour probes just below its top row.
+        List<int> probing;
+        List<Probe> probes(contours.size());
+        List<double> areas(contours.size(), 0.0);
+        for (size_t i = 0; i < contours.size(); ++i)
+        {
+            const Contour& contour = contours[i];
+            if (!contour.closed || contour.points.size() < 3)
+            {
+                continue;
+            }
+            areas[i] = signedArea(contour.points);
+            float top = contour.points.front().y;
+            for (const Math::Point& point : contour.points)
+            {
+                top = std::min(top, point.y);
+            }
+            size_t row = std::lower_bound(rows.begin(), rows.end(), top) - rows.begin();
+            if (areas[i] == 0.0 || row + 1 >= rows.size())
+            {
+                continue; // flat: encloses nothing
+            }
+            probes[i].y = (rows[row] + rows[row + 1]) * 0.5f;
+            probing.push_back(static_cast<int>(i));
+        }
+
+        List<float> lines;
+        for (int i : probing)
+        {
+            lines.push_back(probes[i].y);
+        }
+        std::sort(lines.begin(), lines.end());
+        lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+        for (int i : probing)
+        {
+            probes[i].line = std::lower_bound(lines.begin(), lines.end(), probes[i].y) - lines.begin();
+        }
+
+        // Every crossing of a closed boundary with a probe line, sorted along the line.
+        List<List<Crossing>> crossings(lines.size());
+        for (int i : probing)
+        {
+            forEachSegment(contours[i].points, [&](const Math::Point& a, const Math::Point& b) {
+                const float low = std::min(a.y, b.y), high = std::max(a.y, b.y);
+                auto first = std::upper_bound(lines.begin(), lines.end(), low);
+                auto last = std::lower_bound(first, lines.end(), high);
+                for (auto line = first; line != last; ++line)
+                {
+                    crossings[line - lines.begin()].push_back({ crossingX(a, b, *line), i, b.y > a.y });
+                }
+            });
+        }
+        for (List<Crossing>& line : crossings)
+        {
+            std::sort(line.begin(), line.end(), [](const Crossing& a, const Crossing& b) { return a.x < b.x; });
+        }
+
+        for (int i : probing)
+        {
+            const List<Crossing>& line = crossings[probes[i].line];
+            probes[i].x = std::find_if(line.begin(), line.end(), [&](const Crossing& c) { return c.contour == i; })->x;
+        }
+        std::sort(probing.begin(), probing.end(), [&](int a, int b) {
+            return probes[a].y != probes[b].y ? probes[a].y < probes[b].y : probes[a].x < probes[b].x;
+        });
+
+        for (int i : probing)
+        {
+            Contour& contour = contours[i];
+            const List<Crossing>& line = crossings[probes[i].line];
+            auto own = std::lower_bound(line.begin(), line.end(), probes[i].x, [](const Crossing& c, float x) { return c.x < x; });
+            if (own != line.begin())
+            {
+                // Just right of a crossing is inside a counter-clockwise (on screen) boundary
+                // when it runs downward there, and inside a clockwise one when it runs upward.
+                const Crossing& nearest = *(own - 1);
+                const bool inside = (areas[nearest.contour] < 0.0) == nearest.downward;
+                contour.parent = inside ? nearest.contour : contours[nearest.contour].parent;
+                contour.depth = inside ? contours[nearest.contour].depth + 1 : contours[nearest.contour].depth;
+            }
+            const bool counterClockwise = areas[i] < 0.0;
+            if (counterClockwise != (contour.depth % 2 == 0))
+            {
+                std::reverse(contour.points.begin(), contour.points.end());
+            }
+        }
+
+        std::sort(probing.begin(), probing.end());
+        int components = 0;
+        for (int i : probing)
+        {
+            if (contours[i].depth % 2 == 0)
+            {
+                contours[i].component = components++;
+            }
+        }
+        for (int i : probing)
+        {
+            if (contours[i].depth % 2 == 1)
+            {
+                contours[i].component = contours[contours[i].parent].component;
+            }
+        }
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Vectorizer/Vectorizer.h"
+
+namespace Vectorizer
+{
+    // Fills parent and depth of every closed contour and orients it by depth: outlines
+    // counter-clockwise and holes clockwise on screen. One horizontal ray per contour,
+    // placed between two vertex rows so it never passes through a vertex, finds the nearest
+    // boundary to its left; contours are visited top to bottom so that boundary is already
+    // nested. Outlines are then numbered as components in list order and holes take the number
+    // of their outline. Open contours keep parent -1, depth 0 and component -1.
+    void nestContours(List<Contour>& contours);
+}
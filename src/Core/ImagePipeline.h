@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include "Core/Cancel.h"
+#include "Core/ChainBuilder.h"
+#include "Core/Mask.h"
+#include "Core/MaskCache.h"
+#include "Vectorizer/Vectorizer.h"
+
+namespace Vectorizer
+{
+    // State of one file moving through the decode, extract and simplify stages. A stage
+    // may finish the job early (cache hit or load failure); later stages then do nothing.
+    struct ImageJob {
+        std::string path;
+        List<unsigned char> fileBytes; // may be filled ahead by a batched reader
+        std::uint64_t resultKey = 0;
+        bool hasResultKey = false;
+        MaskCache::Key maskKey;
+        shared<const Mask> mask;
+        List<Math::Chain> chains;
+        bool extracted = false;
+        bool finished = false;
+        const CancelFlag* cancel = nullptr; // cancelled jobs finish empty and are never cached
+    };
+
+    void decodeStage(ImageJob& job, const Options& options);
+    void extractStage(ImageJob& job, const Options& options, Executor* pool);
+    void simplifyStage(ImageJob& job, const Options& options, Executor* pool);
+
+    // Bookkeeping run after job.chains was linked or simplified, for callers that drive the
+    // stages' work themselves: fills the caches and advances the job's state.
+    void commitExtracted(ImageJob& job, const Options& options);
+    void commitSimplified(ImageJob& job, const Options& options);
+
+    // True when the selected simplifier runs inside extractChains, leaving nothing for the
+    // simplify stage to do. Closed loops need the whole chain, so they never stream.
+    bool simplifiesWhileTracing(const Options& options);
+
+    // options.filter converted to the pixels of a mask with the given scale.
+    ChainFilter chainFilter(const Options& options, int scale);
+
+    // Per-image stage sequence shared by the single-image and batch entry points. A pool
+    // is only used to split work inside images of at least ParallelOptions::minSplitPixels.
+    List<Math::Chain> extractChains(const Mask& mask, const Options& options, Executor* pool, const CancelFlag* cancel = nullptr);
+    List<Math::Chain> vectorizeFile(const std::string& path, const Options& options, Executor* pool);
+    List<Math::Chain> vectorizeJob(ImageJob& job, const Options& options, Executor* pool);
+    List<Math::Chain> vectorizeView(const ImageView& image, const Options& options, Executor* pool);
+}
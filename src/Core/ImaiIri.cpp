@@ -0,0 +1,149 @@
+#include <cmath>
+#include <limits>
+#include "Core/Simplify.h"
+
+namespace Vectorizer
+{
+    namespace
+    {
+        constexpr float pi = 3.14159265358979f;
+        // Lattice points often sit exactly at the tolerance; this keeps atan2/asin rounding
+        // from rejecting them.
+        constexpr float toleranceSlack = 1e-4f;
+
+        // Directions from an apex that pass within tolerance of every point added so far, kept
+        // as an angle interval unwrapped around the first constraint's direction.
+        class TangentCone
+        {
+        public:
+            TangentCone(const Math::Point& apex, float tolerance)
+                : apex(apex), tolerance(tolerance * (1.0f + toleranceSlack))
+            {
+            }
+
+            bool empty() const { return isEmpty; }
+
+            void constrain(const Math::Point& point)
+            {
+                Math::Point delta = point - apex;
+                float distance = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+                if (distance <= tolerance)
+                {
+                    return; // every ray from the apex passes within tolerance
+                }
+                float halfAngle = std::asin(tolerance / distance);
+                float angle = std::atan2(delta.y, delta.x);
+                if (!constrained)
+                {
+                    constrained = true;
+                    reference = angle;
+                    low = angle - halfAngle;
+                    high = angle + halfAngle;
+                    return;
+                }
+                angle = unwrap(angle);
+                low = std::max(low, angle - halfAngle);
+                high = std::min(high, angle + halfAngle);
+                isEmpty = low > high;
+            }
+
+            bool contains(const Math::Point& point) const
+            {
+                if (isEmpty)
+                {
+                    return false;
+                }
+                Math::Point delta = point - apex;
+                if (delta.x == 0.0f && delta.y == 0.0f)
+                {
+                    return !constrained;
+                }
+                if (!constrained)
+                {
+                    return true;
+                }
+                float angle = unwrap(std::atan2(delta.y, delta.x));
+                return angle >= low && angle <= high;
+            }
+
+        private:
+            float unwrap(float angle) const
+            {
+                while (angle - reference > pi) angle -= 2.0f * pi;
+                while (angle - reference < -pi) angle += 2.0f * pi;
+                return angle;
+            }
+
+            Math::Point apex;
+            float tolerance;
+            bool constrained = false;
+            bool isEmpty = false;
+            float reference = 0.0f, low = 0.0f, high = 0.0f;
+        };
+    }
+
+    void simplifyImaiIri(Math::Chain& chain, float tolerance, const CancelFlag* cancel)
+    {
+        const size_t count = chain.size();
+        if (count < 3)
+        {
+            return;
+        }
+
+        // A shortcut i -> j is within tolerance of the points between them exactly when p[j]
+        // lies in the cone seen from p[i] and p[i] in the cone seen from p[j]. Backward cones
+        // are recorded first: firstStart[j] is the lowest i scanned from j, and backward[j]
+        // flags which of i = firstStart[j] .. j - 1 passed.
+        List<size_t> firstStart(count);
+        List<List<bool>> backward(count);
+        for (size_t j = 1; j < count; ++j)
+        {
+            if (isCancelled(cancel))
+            {
+                return;
+            }
+            TangentCone cone(chain[j], tolerance);
+            List<bool> flags;
+            size_t i = j;
+            while (i > 0 && !cone.empty())
+            {
+                --i;
+                flags.push_back(cone.contains(chain[i]));
+                cone.constrain(chain[i]);
+            }
+            firstStart[j] = j - flags.size();
+            backward[j].assign(flags.rbegin(), flags.rend());
+        }
+
+        // Shortcuts only go forward, so vertices are final in index order.
+        const size_t unreached = std::numeric_limits<size_t>::max();
+        List<size_t> hops(count, unreached), parent(count, 0);
+        hops[0] = 0;
+        for (size_t i = 0; i + 1 < count; ++i)
+        {
+            if (isCancelled(cancel))
+            {
+                return;
+            }
+            TangentCone cone(chain[i], tolerance);
+            for (size_t j = i + 1; j < count && !cone.empty(); ++j)
+            {
+                const bool valid = cone.contains(chain[j]) && i >= firstStart[j] && backward[j][i - firstStart[j]];
+                if (valid && hops[i] + 1 < hops[j])
+                {
+                    hops[j] = hops[i] + 1;
+                    parent[j] = i;
+                }
+                cone.constrain(chain[j]);
+            }
+        }
+
+        Math::Chain simplified;
+        for (size_t vertex = count - 1; vertex != 0; vertex = parent[vertex])
+        {
+            simplified.push_back(chain[vertex]);
+        }
+        simplified.push_back(chain[0]);
+        chain.assign(simplified.rbegin(), simplified.rend());
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    // d-ary min-heap over the items [0, capacity) whose keys can be changed or removed in
+    // place. Equal keys pop in item order so results don't depend on insertion history.
+    template<unsigned Arity = 4>
+    class IndexedHeap
+    {
+    public:
+        explicit IndexedHeap(size_t capacity)
+            : positions(capacity, absent)
+        {
+        }
+
+        bool empty() const { return nodes.empty(); }
+        size_t size() const { return nodes.size(); }
+        bool contains(size_t item) const { return positions[item] != absent; }
+
+        size_t top() const { return nodes.front().item; }
+        float topKey() const { return nodes.front().key; }
+
+        void push(size_t item, float key)
+        {
+            nodes.push_back({ key, item });
+            positions[item] = nodes.size() - 1;
+            siftUp(nodes.size() - 1);
+        }
+
+        void pop()
+        {
+            remove(top());
+        }
+
+        void update(size_t item, float key)
+        {
+            size_t index = positions[item];
+            nodes[index].key = key;
+            siftUp(index);
+            siftDown(positions[item]);
+        }
+
+        void remove(size_t item)
+        {
+            size_t index = positions[item];
+            positions[item] = absent;
+            Node last = nodes.back();
+            nodes.pop_back();
+            if (index < nodes.size())
+            {
+                nodes[index] = last;
+                positions[last.item] = index;
+                siftUp(index);
+                siftDown(positions[last.item]);
+            }
+        }
+
+    private:
+        struct Node {
+            float key;
+            size_t item;
+        };
+
+        static constexpr size_t absent = std::numeric_limits<size_t>::max();
+
+        static bool before(const Node& a, const Node& b)
+        {
+            return a.key < b.key || (a.key == b.key && a.item < b.item);
+        }
+
+        void siftUp(size_t index)
+        {
+            Node node = nodes[index];
+            while (index > 0)
+            {
+                size_t parent = (index - 1) / Arity;
+                if (!before(node, nodes[parent]))
+                {
+                    break;
+                }
+                nodes[index] = nodes[parent];
+                positions[nodes[index].item] = index;
+                index = parent;
+            }
+            nodes[index] = node;
+            positions[node.item] = index;
+        }
+
+        void siftDown(size_t index)
+        {
+            Node node = nodes[index];
+            while (true)
+            {
+                size_t firstChild = index * Arity + 1;
+                if (firstChild >= nodes.size())
+                {
+                    break;
+                }
+                size_t best = firstChild;
+                size_t lastChild = std::min(firstChild + Arity, nodes.size());
+                for (size_t child = firstChild + 1; child < lastChild; ++child)
+                {
+                    if (before(nodes[child], nodes[best]))
+                    {
+                        best = child;
+                    }
+                }
+                if (!before(nodes[best], node))
+                {
+                    break;
+                }
+                nodes[index] = nodes[best];
+                positions[nodes[index].item] = index;
+                index = best;
+            }
+            nodes[index] = node;
+            positions[node.item] = index;
+        }
+
+        List<Node> nodes;
+        List<size_t> positions;
+    };
+}
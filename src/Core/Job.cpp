@@ -0,0 +1,166 @@
+#include <algorithm>
+#include "Core/ChainBuilder.h"
+#include "Core/ImagePipeline.h"
+#include "Core/MarchingSquares.h"
+#include "Core/Simplify.h"
+#include "Vectorizer/Job.h"
+
+namespace Vectorizer
+{
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t linksPerSlice = 256;
+
+    enum class JobPhase { Decode, Threshold, March, Link, Simplify, Done };
+
+    struct VectorizeJob::State {
+        Options options;
+        ImageJob job;
+        JobPhase phase = JobPhase::Decode;
+        ImageData view{};                 // source pixels of view jobs
+        Mask mask;                        // filled row by row for view jobs
+        Occupancy occupancy;
+        int row = 0;
+        List<LatticeSegment> segments;
+        unique<ChainLinker> linker;
+        size_t chainIndex = 0;
+
+        void advance();
+    };
+
+    // Performs one small unit of work: a mask row, a slice of links or a chain.
+    void VectorizeJob::State::advance()
+    {
+        switch (phase)
+        {
+        case JobPhase::Decode:
+            decodeStage(job, options);
+            if (job.finished)
+            {
+                phase = JobPhase::Done;
+            }
+            else if (job.extracted)
+            {
+                phase = JobPhase::Simplify;
+            }
+            else
+            {
+                occupancy = buildOccupancy(*job.mask);
+                phase = JobPhase::March;
+                row = -1;
+            }
+            break;
+
+        case JobPhase::Threshold:
+            thresholdRows(view, mask, row, row + 1);
+            if (++row == mask.height)
+            {
+                job.mask = std::make_shared<const Mask>(std::move(mask));
+                occupancy = buildOccupancy(*job.mask);
+                phase = JobPhase::March;
+                row = -1;
+            }
+            break;
+
+        case JobPhase::March:
+            if (options.components.enabled)
+            {
+                // Labeling needs the whole mask, so component tracing is a single step.
+                occupancy = Occupancy{};
+                job.chains = extractChains(*job.mask, options, nullptr);
+                commitExtracted(job, options);
+                phase = JobPhase::Simplify;
+                chainIndex = 0;
+                break;
+            }
+            marchRows(*job.mask, occupancy, row, row + 1, segments);
+            if (++row == job.mask->height)
+            {
+                occupancy = Occupancy{};
+                linker = std::make_unique<ChainLinker>(std::move(segments), 0.0f, chainFilter(options, job.mask->scale));
+                phase = JobPhase::Link;
+            }
+            break;
+
+        case JobPhase::Link:
+            if (linker->link(linksPerSlice))
+            {
+                job.chains = linker->takeChains();
+                linker = nullptr;
+                keepLargestChains(job.chains, options.filter.maxChains);
+                scaleToSource(job.chains, *job.mask);
+                commitExtracted(job, options);
+                phase = JobPhase::Simplify;
+                chainIndex = 0;
+            }
+            break;
+
+        case JobPhase::Simplify:
+            if (options.simplify.preserveTopology && chainIndex < job.chains.size())
+            {
+                // Every shortcut is checked against all chains, so they go in one step.
+                simplifyChains(job.chains, options.tolerance, options.simplify);
+                chainIndex = job.chains.size();
+            }
+            else if (chainIndex < job.chains.size())
+            {
+                simplifyContour(job.chains[chainIndex++], options.tolerance, options.simplify);
+            }
+            else
+            {
+                applyVertexBudget(job.chains, options.simplify.maxVerticesPerChain, options.simplify.maxVerticesPerImage);
+                commitSimplified(job, options);
+                phase = JobPhase::Done;
+            }
+            break;
+
+        case JobPhase::Done:
+            break;
+        }
+    }
+
+    VectorizeJob::VectorizeJob(const std::string& path, const Options& options)
+        : state(std::make_unique<State>())
+    {
+        state->options = options;
+        state->job.path = path;
+    }
+
+    VectorizeJob::VectorizeJob(const ImageView& image, const Options& options)
+        : state(std::make_unique<State>())
+    {
+        state->options = options;
+        state->view = ImageData{ "", image.width, image.height, image.channels, image.data };
+        if (!state->view.isValid() || image.width <= 0 || image.height <= 0)
+        {
+            std::cerr << "Error: invalid image view" << std::endl;
+            state->phase = JobPhase::Done;
+            return;
+        }
+        state->mask = allocateMask(image.width, image.height, clampDownsampleFactor(options.downsampleFactor));
+        state->phase = JobPhase::Threshold;
+    }
+
+    VectorizeJob::~VectorizeJob() = default;
+
+    bool VectorizeJob::step(std::chrono::microseconds budget)
+    {
+        const Clock::time_point deadline = Clock::now() + budget;
+        do
+        {
+            state->advance();
+        } while (state->phase != JobPhase::Done && Clock::now() < deadline);
+        return done();
+    }
+
+    bool VectorizeJob::done() const
+    {
+        return state->phase == JobPhase::Done;
+    }
+
+    const List<Math::Chain>& VectorizeJob::results() const
+    {
+        static const List<Math::Chain> empty;
+        return done() ? state->job.chains : empty;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Core/Hash.h"
+#include "Vectorizer/Math.h"
+
+namespace Vectorizer
+{
+    // Traced vertices only ever land on the half-pixel lattice, so internally they are kept
+    // as exact doubled integer coordinates (2x, 2y) and converted to floats on output.
+    struct LatticePoint {
+        std::int32_t x2, y2;
+
+        bool operator==(const LatticePoint& other) const { return x2 == other.x2 && y2 == other.y2; }
+        bool operator!=(const LatticePoint& other) const { return !(*this == other); }
+    };
+
+    struct LatticeSegment {
+        LatticePoint start, end;
+    };
+
+    // Both coordinates packed into one word, for exact hashing.
+    inline std::uint64_t latticeKey(LatticePoint point)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(point.y2)) << 32) | static_cast<std::uint32_t>(point.x2);
+    }
+
+    struct LatticeKeyHash {
+        size_t operator()(std::uint64_t key) const { return static_cast<size_t>(Hash::mix(key)); }
+    };
+
+    inline Math::Point toPoint(LatticePoint point)
+    {
+        return { point.x2 * 0.5f, point.y2 * 0.5f };
+    }
+}
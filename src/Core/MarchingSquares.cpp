@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <climits>
+#include "Core/Bits.h"
+#include "Core/MarchingSquares.h"
+#include "Core/Parallel.h"
+
+namespace Vectorizer
+{
+    // State shared by pixel column x in rows y and y + 1, i.e. one side of cell (x, y).
+    static BlockState combineRows(const OccupancyLevel& level, const Mask& mask, int x, int y)
+    {
+        BlockState top = level.stateOfPixel(x, y, mask.width, mask.height);
+        BlockState bottom = level.stateOfPixel(x, y + 1, mask.width, mask.height);
+        return top == bottom ? top : BlockState::Mixed;
+    }
+
+    static constexpr size_t minAverageRunLength = 32;
+
+    // Edges are numbered top, right, bottom, left; each case lists its segments as edge pairs.
+    struct EdgeRule {
+        int count;
+        int edges[2][2];
+    };
+    static constexpr EdgeRule marchingSquaresLUT[16] = {
+        { 0, {} },                          // Case 0: ----
+        { 1, { {0, 3} } },                  // Case 1: #---
+        { 1, { {1, 0} } },                  // Case 2: -#--
+        { 1, { {1, 3} } },                  // Case 3: ##--
+        { 1, { {2, 1} } },                  // Case 4: --#-
+        { 2, { {0, 3}, {2, 1} } },          // Case 5: #-#-
+        { 1, { {2, 0} } },                  // Case 6: -##-
+        { 1, { {2, 3} } },                  // Case 7: ###-
+        { 1, { {3, 2} } },                  // Case 8: ---#
+        { 1, { {0, 2} } },                  // Case 9: #--#
+        { 2, { {1, 0}, {3, 2} } },          // Case 10: -#-#
+        { 1, { {1, 2} } },                  // Case 11: #-##
+        { 1, { {3, 1} } },                  // Case 12: --##
+        { 1, { {0, 1} } },                  // Case 13: #.##
+        { 1, { {3, 0} } },                  // Case 14: -###
+        { 0, {} }                           // Case 15: ####
+    };
+
+    // Edge midpoints relative to the cell's top-left corner, in half pixels.
+    static constexpr int edgeMidpoints[4][2] = { {1, 0}, {2, 1}, {1, 2}, {0, 1} };
+
+    // Segment endpoints of each case as lattice offsets from (2x, 2y), resolved at compile time.
+    struct CaseEmission {
+        int count = 0;
+        std::int32_t offsets[2][4] = {}; // start x, start y, end x, end y
+    };
+
+    struct EmissionTable {
+        CaseEmission cases[16];
+    };
+
+    static constexpr EmissionTable buildEmissionTable()
+    {
+        EmissionTable table{};
+        for (int index = 0; index < 16; ++index)
+        {
+            const EdgeRule& rule = marchingSquaresLUT[index];
+            table.cases[index].count = rule.count;
+            for (int segment = 0; segment < rule.count; ++segment)
+            {
+                std::int32_t* offsets = table.cases[index].offsets[segment];
+                offsets[0] = edgeMidpoints[rule.edges[segment][0]][0];
+                offsets[1] = edgeMidpoints[rule.edges[segment][0]][1];
+                offsets[2] = edgeMidpoints[rule.edges[segment][1]][0];
+                offsets[3] = edgeMidpoints[rule.edges[segment][1]][1];
+            }
+        }
+        return table;
+    }
+
+    static constexpr EmissionTable emissionTable = buildEmissionTable();
+
+    static void emitCell(int index, int x, int y, LatticeSegment*& out)
+    {
+        const CaseEmission& emission = emissionTable.cases[index];
+        const std::int32_t cellX = 2 * x;
+        const std::int32_t cellY = 2 * y;
+        for (int segment = 0; segment < emission.count; ++segment)
+        {
+            const std::int32_t* offsets = emission.offsets[segment];
+            *out++ = { { cellX + offsets[0], cellY + offsets[1] }, { cellX + offsets[2], cellY + offsets[3] } };
+        }
+    }
+
+    // Returns the first cell after x whose corners aren't known to match cell x's, or x when
+    // the occupancy can't tell. Coarse blocks are tried first so uniform areas cost one
+    // lookup per 64 cells.
+    static int skipUniformCells(const Mask& mask, const Occupancy& occupancy, int x, int y)
+    {
+        for (auto level = occupancy.levels.rbegin(); level != occupancy.levels.rend(); ++level)
+        {
+            BlockState left = combineRows(*level, mask, x, y);
+            BlockState right = combineRows(*level, mask, x + 1, y);
+            if (left != right || left == BlockState::Mixed)
+            {
+                continue;
+            }
+            if (x + 1 >= mask.width)
+            {
+                return x + 1;
+            }
+            // Every cell whose right column stays in x + 1's block sees the same state.
+            const int blockEnd = ((x + 1) / level->blockSize + 1) * level->blockSize;
+            return std::min(blockEnd, mask.width) - 1;
+        }
+        return x;
+    }
+
+    // Writes the segments of cell rows [beginY, endY) from out on and returns the new end.
+    static LatticeSegment* fillRows(const Mask& mask, const Occupancy& occupancy, int beginY, int endY, LatticeSegment* out, const CancelFlag* cancel)
+    {
+        for (int y = beginY; y < endY; ++y)
+        {
+            if (isCancelled(cancel))
+            {
+                return out;
+            }
+            for (int x = -1; x < mask.width; ++x)
+            {
+                int next = skipUniformCells(mask, occupancy, x, y);
+                if (next > x)
+                {
+                    x = next - 1;
+                    continue;
+                }
+
+                bool topLeft = mask.isSolid(x, y);
+                bool topRight = mask.isSolid(x + 1, y);
+                bool bottomLeft = mask.isSolid(x, y + 1);
+                bool bottomRight = mask.isSolid(x + 1, y + 1);
+
+                int index = 0;
+                if (topLeft) index += 1;
+                if (topRight) index += 2;
+                if (bottomRight) index += 4;
+                if (bottomLeft) index += 8;
+                emitCell(index, x, y, out);
+            }
+        }
+        return out;
+    }
+
+    // Walks the run boundaries of rows y and y + 1 together. Only the cell left of each
+    // boundary column mixes states horizontally; the cells between two boundaries are either
+    // uniform or a straight horizontal edge, so no pixel is ever sampled.
+    static void fillRunRow(const RunMask& runs, int y, LatticeSegment*& out)
+    {
+        const Run* top = nullptr;
+        const Run* topEnd = nullptr;
+        const Run* bottom = nullptr;
+        const Run* bottomEnd = nullptr;
+        if (y >= 0)
+        {
+            top = runs.rowBegin(y);
+            topEnd = runs.rowEnd(y);
+        }
+        if (y + 1 < runs.height)
+        {
+            bottom = runs.rowBegin(y + 1);
+            bottomEnd = runs.rowEnd(y + 1);
+        }
+        bool topSolid = false, bottomSolid = false;
+
+        int x = -1;
+        while (top != topEnd || bottom != bottomEnd)
+        {
+            const int topNext = top != topEnd ? (topSolid ? top->end : top->begin) : INT_MAX;
+            const int bottomNext = bottom != bottomEnd ? (bottomSolid ? bottom->end : bottom->begin) : INT_MAX;
+            const int column = std::min(topNext, bottomNext);
+
+            // Cells x .. column - 2 have the same state in both of their columns.
+            if (topSolid != bottomSolid)
+            {
+                const int index = topSolid ? 3 : 12;
+                for (; x < column - 1; ++x)
+                {
+                    emitCell(index, x, y, out);
+                }
+            }
+
+            bool topRight = topSolid, bottomRight = bottomSolid;
+            if (topNext == column)
+            {
+                topRight = !topSolid;
+                top += topSolid ? 1 : 0;
+            }
+            if (bottomNext == column)
+            {
+                bottomRight = !bottomSolid;
+                bottom += bottomSolid ? 1 : 0;
+            }
+            const int index = (topSolid ? 1 : 0) + (topRight ? 2 : 0) + (bottomRight ? 4 : 0) + (bottomSolid ? 8 : 0);
+            emitCell(index, column - 1, y, out);
+
+            topSolid = topRight;
+            bottomSolid = bottomRight;
+            x = column;
+        }
+    }
+
+    static LatticeSegment* fillRunRows(const RunMask& runs, int beginY, int endY, LatticeSegment* out, const CancelFlag* cancel)
+    {
+        for (int y = beginY; y < endY; ++y)
+        {
+            if (isCancelled(cancel))
+            {
+                return out;
+            }
+            fillRunRow(runs, y, out);
+        }
+        return out;
+    }
+
+    size_t countSegments(const Mask& mask, int beginY, int endY)
+    {
+        // Cell (x, y) is handled in the word holding its right column x + 1. Columns -1 and
+        // width read as empty, so one extra word covers the last cell when width % 64 == 0.
+        auto word = [&](int y, int index) -> std::uint64_t {
+            if (y < 0 || y >= mask.height || index >= mask.wordsPerRow)
+            {
+                return 0;
+            }
+            return mask.bits[static_cast<size_t>(y) * mask.wordsPerRow + index];
+        };
+
+        size_t count = 0;
+        for (int y = beginY; y < endY; ++y)
+        {
+            std::uint64_t previousTop = 0, previousBottom = 0;
+            for (int index = 0; index * 64 <= mask.width; ++index)
+            {
+                const std::uint64_t topRight = word(y, index);
+                const std::uint64_t bottomRight = word(y + 1, index);
+                const std::uint64_t topLeft = (topRight << 1) | (previousTop >> 63);
+                const std::uint64_t bottomLeft = (bottomRight << 1) | (previousBottom >> 63);
+                previousTop = topRight;
+                previousBottom = bottomRight;
+
+                const int validColumns = std::min(64, mask.width + 1 - index * 64);
+                const std::uint64_t valid = validColumns == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << validColumns) - 1;
+
+                // Every mixed cell emits one segment and the two saddle cases emit a second.
+                const std::uint64_t mixed = (topLeft ^ topRight) | (bottomLeft ^ bottomRight) | (topLeft ^ bottomLeft);
+                const std::uint64_t saddle = (topLeft ^ topRight) & ~(topLeft ^ bottomRight) & ~(topRight ^ bottomLeft);
+                count += Bits::popCount(mixed & valid) + Bits::popCount(saddle & valid);
+            }
+        }
+        return count;
+    }
+
+    void marchRows(const Mask& mask, const Occupancy& occupancy, int beginY, int endY, List<LatticeSegment>& allSegments, const CancelFlag* cancel)
+    {
+        const size_t begin = allSegments.size();
+        allSegments.resize(begin + countSegments(mask, beginY, endY));
+        LatticeSegment* end = fillRows(mask, occupancy, beginY, endY, allSegments.data() + begin, cancel);
+        allSegments.resize(static_cast<size_t>(end - allSegments.data()));
+    }
+
+    void marchRunRows(const RunMask& runs, const Mask& mask, int beginY, int endY, List<LatticeSegment>& allSegments, const CancelFlag* cancel)
+    {
+        const size_t begin = allSegments.size();
+        allSegments.resize(begin + countSegments(mask, beginY, endY));
+        LatticeSegment* end = fillRunRows(runs, beginY, endY, allSegments.data() + begin, cancel);
+        allSegments.resize(static_cast<size_t>(end - allSegments.data()));
+    }
+
+    List<LatticeSegment> marchingSquares(const Mask& mask, Executor* pool, int bandRows, const CancelFlag* cancel)
+    {
+        // Long runs make the run-driven march cheaper than sampling cells; otherwise fall back
+        // to the occupancy pyramid, which still skips uniform blocks. Runs are only counted
+        // to decide, and encoded once the run march is chosen.
+        const bool useRuns = countRuns(mask) * minAverageRunLength <= static_cast<size_t>(mask.width) * mask.height;
+        const RunMask runs = useRuns ? encodeRuns(mask) : RunMask{};
+        const Occupancy occupancy = useRuns ? Occupancy{} : buildOccupancy(mask);
+        auto fill = [&](int beginY, int endY, LatticeSegment* out) {
+            return useRuns ? fillRunRows(runs, beginY, endY, out, cancel) : fillRows(mask, occupancy, beginY, endY, out, cancel);
+        };
+
+        // Counting first sizes the output exactly, so it is filled in place without regrowing.
+        const int cellRows = mask.height + 1; // cell rows run from y = -1 to height - 1
+        if (!pool || bandRows <= 0 || cellRows <= bandRows)
+        {
+            List<LatticeSegment> allSegments(countSegments(mask, -1, mask.height));
+            fill(-1, mask.height, allSegments.data());
+            return isCancelled(cancel) ? List<LatticeSegment>{} : allSegments;
+        }
+
+        // Each band writes its own disjoint range of the shared buffer, found by a prefix sum
+        // over the band counts, so the output matches the serial march exactly.
+        const size_t bandCount = static_cast<size_t>((cellRows + bandRows - 1) / bandRows);
+        auto bandRange = [&](size_t band) {
+            int beginY = -1 + static_cast<int>(band) * bandRows;
+            return std::make_pair(beginY, std::min(beginY + bandRows, mask.height));
+        };
+        List<size_t> bandOffsets(bandCount + 1, 0);
+        parallelFor(pool, bandCount, [&](size_t band) {
+            auto range = bandRange(band);
+            bandOffsets[band + 1] = countSegments(mask, range.first, range.second);
+        });
+        for (size_t band = 0; band < bandCount; ++band)
+        {
+            bandOffsets[band + 1] += bandOffsets[band];
+        }
+
+        List<LatticeSegment> allSegments(bandOffsets.back());
+        parallelFor(pool, bandCount, [&](size_t band) {
+            auto range = bandRange(band);
+            fill(range.first, range.second, allSegments.data() + bandOffsets[band]);
+        });
+        // A cancelled band leaves its range partly unwritten.
+        return isCancelled(cancel) ? List<LatticeSegment>{} : allSegments;
+    }
+}
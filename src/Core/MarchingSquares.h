@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Core/Cancel.h"
+#include "Core/Lattice.h"
+#include "Core/Mask.h"
+#include "Core/Occupancy.h"
+#include "Core/RunMask.h"
+#include "Vectorizer/Math.h"
+#include "Vectorizer/Executor.h"
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    // Number of segments marchRows emits for cell rows [beginY, endY), from popcounts over
+    // the packed rows.
+    size_t countSegments(const Mask& mask, int beginY, int endY);
+
+    // Appends the segments of cell rows [beginY, endY); cell row y spans mask rows y and y + 1.
+    // Runs of cells inside uniform occupancy blocks are skipped without being sampled.
+    void marchRows(const Mask& mask, const Occupancy& occupancy, int beginY, int endY, List<LatticeSegment>& allSegments, const CancelFlag* cancel = nullptr);
+
+    // Same output as marchRows, driven by the run boundaries of each pair of rows.
+    void marchRunRows(const RunMask& runs, const Mask& mask, int beginY, int endY, List<LatticeSegment>& allSegments, const CancelFlag* cancel = nullptr);
+
+    // Marches the whole mask, split into bands of bandRows cell rows when a pool is given.
+    List<LatticeSegment> marchingSquares(const Mask& mask, Executor* pool = nullptr, int bandRows = 0, const CancelFlag* cancel = nullptr);
+}
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include "Core/Mask.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VEC_MASK_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VEC_MASK_NEON 1
+#endif
+
+namespace Vectorizer
+{
+    // Adds 1 to counts[x] for every solid pixel of a single-channel row.
+    static void accumulateSolid(const unsigned char* row, int width, unsigned char* counts)
+    {
+        int x = 0;
+#if defined(VEC_MASK_SSE2)
+        // Bytes below 128 are non-negative as signed values; the compare yields 0xFF (-1) for them.
+        const __m128i minusOne = _mm_set1_epi8(-1);
+        for (; x + 16 <= width; x += 16)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+            __m128i solid = _mm_cmpgt_epi8(pixels, minusOne);
+            __m128i sum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counts + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(counts + x), _mm_sub_epi8(sum, solid));
+        }
+#elif defined(VEC_MASK_NEON)
+        const uint8x16_t threshold = vdupq_n_u8(128);
+        for (; x + 16 <= width; x += 16)
+        {
+            uint8x16_t solid = vcltq_u8(vld1q_u8(row + x), threshold);
+            vst1q_u8(counts + x, vsubq_u8(vld1q_u8(counts + x), solid));
+        }
+#endif
+        for (; x < width; ++x)
+        {
+            counts[x] += row[x] < 128;
+        }
+    }
+
+    Mask allocateMask(int sourceWidth, int sourceHeight, int scale)
+    {
+        Mask mask;
+        mask.scale = scale;
+        mask.sourceWidth = sourceWidth;
+        mask.sourceHeight = sourceHeight;
+        mask.width = (sourceWidth + scale - 1) / scale;
+        mask.height = (sourceHeight + scale - 1) / scale;
+        mask.wordsPerRow = (mask.width + 63) / 64;
+        mask.bits.assign(static_cast<size_t>(mask.wordsPerRow) * mask.height, 0);
+        return mask;
+    }
+
+    Mask downsampleMask(const Mask& mask, int factor)
+    {
+        Mask result = allocateMask(mask.width, mask.height, factor);
+        result.scale = mask.scale * factor;
+        result.sourceWidth = mask.sourceWidth;
+        result.sourceHeight = mask.sourceHeight;
+        for (int y = 0; y < result.height; ++y)
+        {
+            const int rowEnd = std::min((y + 1) * factor, mask.height);
+            for (int x = 0; x < result.width; ++x)
+            {
+                const int columnEnd = std::min((x + 1) * factor, mask.width);
+                int count = 0;
+                for (int sy = y * factor; sy < rowEnd; ++sy)
+                {
+                    for (int sx = x * factor; sx < columnEnd; ++sx)
+                    {
+                        count += mask.isSolid(sx, sy);
+                    }
+                }
+                const int area = (rowEnd - y * factor) * (columnEnd - x * factor);
+                if (count >= (area + 1) / 2)
+                {
+                    result.setSolid(x, y);
+                }
+            }
+        }
+        return result;
+    }
+
+    // Mask pixel centres map onto block centres and the edges between mask pixels onto block
+    // edges. Past the edge before the last block, the last block's real extent is used.
+    static float toSourceCoordinate(float value, int scale, int maskSize, int sourceSize)
+    {
+        const float lastEdge = maskSize - 1.5f;
+        if (value <= lastEdge)
+        {
+            return value * scale + (scale - 1) * 0.5f;
+        }
+        const int lastBegin = (maskSize - 1) * scale;
+        return lastBegin - 0.5f + (value - lastEdge) * static_cast<float>(sourceSize - lastBegin);
+    }
+
+    void scaleToSource(List<Math::Chain>& chains, const Mask& mask)
+    {
+        if (mask.scale == 1)
+        {
+            return;
+        }
+        for (Math::Chain& chain : chains)
+        {
+            for (Math::Point& point : chain)
+            {
+                point.x = toSourceCoordinate(point.x, mask.scale, mask.width, mask.sourceWidth);
+                point.y = toSourceCoordinate(point.y, mask.scale, mask.height, mask.sourceHeight);
+            }
+        }
+    }
+
+    Mask thresholdImage(const ImageData& image, int factor)
+    {
+        Mask mask = allocateMask(image.width, image.height, clampDownsampleFactor(factor));
+        thresholdRows(image, mask, 0, mask.height);
+        return mask;
+    }
+
+    void thresholdRows(const ImageData& image, Mask& mask, int beginY, int endY)
+    {
+        const size_t rowStride = static_cast<size_t>(image.width) * image.channels;
+        if (mask.scale == 1)
+        {
+            for (int y = beginY; y < endY; ++y)
+            {
+                const unsigned char* row = image.data + y * rowStride;
+                for (int x = 0; x < image.width; ++x)
+                {
+                    if (row[x * image.channels] < 128)
+                    {
+                        mask.setSolid(x, y);
+                    }
+                }
+            }
+            return;
+        }
+
+        // Box filter: count solid pixels per source column over the block's rows (vectorized),
+        // then sum each block's columns and compare against the majority.
+        const int factor = mask.scale;
+        List<unsigned char> columnCounts(image.width);
+        List<unsigned char> firstChannel(image.channels == 1 ? 0 : image.width);
+        for (int y = beginY; y < endY; ++y)
+        {
+            std::fill(columnCounts.begin(), columnCounts.end(), 0);
+            const int sourceEnd = std::min((y + 1) * factor, image.height);
+            for (int sourceY = y * factor; sourceY < sourceEnd; ++sourceY)
+            {
+                const unsigned char* row = image.data + sourceY * rowStride;
+                if (image.channels != 1)
+                {
+                    for (int x = 0; x < image.width; ++x)
+                    {
+                        firstChannel[x] = row[x * image.channels];
+                    }
+                    row = firstChannel.data();
+                }
+                accumulateSolid(row, image.width, columnCounts.data());
+            }
+
+            for (int x = 0; x < mask.width; ++x)
+            {
+                const int sourceBegin = x * factor;
+                const int sourceStop = std::min(sourceBegin + factor, image.width);
+                int count = 0;
+                for (int sourceX = sourceBegin; sourceX < sourceStop; ++sourceX)
+                {
+                    count += columnCounts[sourceX];
+                }
+                const int area = (sourceStop - sourceBegin) * (sourceEnd - y * factor);
+                if (count >= (area + 1) / 2)
+                {
+                    mask.setSolid(x, y);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "IO/ImageLoader.h"
+#include "Vectorizer/Math.h"
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    // Box filter counts are kept in bytes, so a block may span at most 255 rows.
+    static constexpr int maxDownsampleFactor = 255;
+
+    inline int clampDownsampleFactor(int factor)
+    {
+        return std::min(std::max(factor, 1), maxDownsampleFactor);
+    }
+
+    // Thresholded image packed to one bit per pixel, 64 pixels per word along each row.
+    // A downsampled mask covers scale x scale source pixels with each of its pixels; the
+    // last column and row of blocks are cut short by the source size.
+    struct Mask {
+        int width = 0, height = 0;
+        int wordsPerRow = 0;
+        int scale = 1;
+        int sourceWidth = 0, sourceHeight = 0;
+        List<std::uint64_t> bits;
+
+        bool isSolid(int x, int y) const
+        {
+            if (x < 0 || y < 0 || x >= width || y >= height)
+            {
+                return false;
+            }
+            return (bits[static_cast<size_t>(y) * wordsPerRow + (x >> 6)] >> (x & 63)) & 1u;
+        }
+
+        void setSolid(int x, int y)
+        {
+            bits[static_cast<size_t>(y) * wordsPerRow + (x >> 6)] |= std::uint64_t(1) << (x & 63);
+        }
+
+        size_t memoryUsage() const
+        {
+            return sizeof(Mask) + bits.size() * sizeof(std::uint64_t);
+        }
+    };
+
+    // Thresholds the first channel at 128. With a factor above 1 (at most
+    // maxDownsampleFactor) the image is box filtered on the fly: a mask pixel is solid when
+    // at least half of the source pixels in its block are.
+    Mask thresholdImage(const ImageData& image, int factor = 1);
+
+    // Same majority filter applied to an existing mask; the result's scale accumulates.
+    Mask downsampleMask(const Mask& mask, int factor);
+
+    // Maps chains traced on a downsampled mask back onto source pixel coordinates, keeping
+    // points of the cut-short edge blocks inside the source image.
+    void scaleToSource(List<Math::Chain>& chains, const Mask& mask);
+
+    // Building blocks of thresholdImage for callers that fill the mask a few rows at a time.
+    // Rows are mask rows, each covering mask.scale source rows.
+    Mask allocateMask(int sourceWidth, int sourceHeight, int scale = 1);
+    void thresholdRows(const ImageData& image, Mask& mask, int beginY, int endY);
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include "Core/Hash.h"
+#include "Core/MaskCache.h"
+
+namespace Vectorizer
+{
+    namespace MaskCache
+    {
+        struct Slot {
+            Entry entry;
+            size_t bytes = 0;
+            std::list<std::string>::iterator lruPosition;
+        };
+
+        static std::mutex cacheMutex;
+        static Dictionary<std::string, Slot> slots;
+        static std::list<std::string> lruOrder; // most recently used first
+        static size_t budgetBytes = 256ull * 1024 * 1024;
+        static size_t usedBytes = 0;
+        static std::uint64_t hitCount = 0;
+        static std::uint64_t missCount = 0;
+        static std::uint64_t evictionCount = 0;
+
+        static std::string slotName(const Key& key)
+        {
+            return key.path + '\n' + std::to_string(key.modifiedTime) + '\n' + std::to_string(key.scale);
+        }
+
+        static size_t chainsMemoryUsage(const List<Math::Chain>& chains)
+        {
+            size_t bytes = sizeof(List<Math::Chain>) + chains.size() * sizeof(Math::Chain);
+            for (const Math::Chain& chain : chains)
+            {
+                bytes += chain.size() * sizeof(Math::Point);
+            }
+            return bytes;
+        }
+
+        // Callers hold cacheMutex.
+        static void evictOverBudget()
+        {
+            while (usedBytes > budgetBytes && !lruOrder.empty())
+            {
+                auto found = slots.find(lruOrder.back());
+                usedBytes -= found->second.bytes;
+                slots.erase(found);
+                lruOrder.pop_back();
+                evictionCount++;
+            }
+        }
+
+        static Slot& touchSlot(const std::string& name)
+        {
+            auto found = slots.find(name);
+            if (found == slots.end())
+            {
+                lruOrder.push_front(name);
+                Slot& slot = slots[name];
+                slot.lruPosition = lruOrder.begin();
+                return slot;
+            }
+            lruOrder.splice(lruOrder.begin(), lruOrder, found->second.lruPosition);
+            return found->second;
+        }
+
+        Key makeKey(const std::string& path, const Options& options)
+        {
+            Key key;
+            key.path = path;
+            key.scale = clampDownsampleFactor(options.downsampleFactor);
+            key.chainFilter = Hash::combine(Hash::mix(options.filter.minPoints), Hash::floatBits(options.filter.minArea));
+            key.chainFilter = Hash::combine(key.chainFilter, Hash::floatBits(options.filter.minSize));
+            key.chainFilter = Hash::combine(key.chainFilter, options.filter.maxChains);
+            std::error_code error;
+            auto modified = std::filesystem::last_write_time(path, error);
+            if (!error)
+            {
+                key.modifiedTime = modified.time_since_epoch().count();
+                key.valid = true;
+            }
+            return key;
+        }
+
+        Entry lookup(const Key& key)
+        {
+            if (!key.valid)
+            {
+                return {};
+            }
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            auto found = slots.find(slotName(key));
+            if (found == slots.end())
+            {
+                missCount++;
+                return {};
+            }
+            hitCount++;
+            lruOrder.splice(lruOrder.begin(), lruOrder, found->second.lruPosition);
+            Entry entry = found->second.entry;
+            if (entry.rawChainsFilter != key.chainFilter)
+            {
+                entry.rawChains = nullptr;
+            }
+            return entry;
+        }
+
+        void storeMask(const Key& key, shared<const Mask> mask)
+        {
+            if (!key.valid || !mask)
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            Slot& slot = touchSlot(slotName(key));
+            if (slot.entry.mask)
+            {
+                slot.bytes -= slot.entry.mask->memoryUsage();
+                usedBytes -= slot.entry.mask->memoryUsage();
+            }
+            slot.entry.mask = std::move(mask);
+            slot.bytes += slot.entry.mask->memoryUsage();
+            usedBytes += slot.entry.mask->memoryUsage();
+            evictOverBudget();
+        }
+
+        void storeRawChains(const Key& key, shared<const List<Math::Chain>> rawChains)
+        {
+            if (!key.valid || !rawChains)
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            Slot& slot = touchSlot(slotName(key));
+            if (slot.entry.rawChains)
+            {
+                slot.bytes -= chainsMemoryUsage(*slot.entry.rawChains);
+                usedBytes -= chainsMemoryUsage(*slot.entry.rawChains);
+            }
+            slot.entry.rawChains = std::move(rawChains);
+            slot.entry.rawChainsFilter = key.chainFilter;
+            slot.bytes += chainsMemoryUsage(*slot.entry.rawChains);
+            usedBytes += chainsMemoryUsage(*slot.entry.rawChains);
+            evictOverBudget();
+        }
+
+        void setBudget(size_t bytes)
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            budgetBytes = bytes;
+            evictOverBudget();
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            slots.clear();
+            lruOrder.clear();
+            usedBytes = 0;
+        }
+
+        CacheStats stats()
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            CacheStats result;
+            result.hits = hitCount;
+            result.misses = missCount;
+            result.evictions = evictionCount;
+            return result;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "Core/Mask.h"
+#include "Vectorizer/Vectorizer.h"
+
+namespace Vectorizer
+{
+    // Process-wide LRU cache of decoded masks and their unsimplified chains, keyed by
+    // path and modification time so edited files are picked up again. Safe to use from
+    // several threads at once; cached values are immutable and shared.
+    namespace MaskCache
+    {
+        struct Key {
+            std::string path;
+            std::int64_t modifiedTime = 0;
+            int scale = 1; // masks thresholded at different downsample factors don't mix
+            std::uint64_t chainFilter = 0; // raw chains are only reused under the same filter
+            bool valid = false;
+        };
+
+        struct Entry {
+            shared<const Mask> mask;
+            shared<const List<Math::Chain>> rawChains;
+            std::uint64_t rawChainsFilter = 0;
+        };
+
+        Key makeKey(const std::string& path, const Options& options);
+
+        Entry lookup(const Key& key);
+        void storeMask(const Key& key, shared<const Mask> mask);
+        void storeRawChains(const Key& key, shared<const List<Math::Chain>> rawChains);
+
+        void setBudget(size_t bytes);
+        void clear();
+        CacheStats stats();
+    }
+}
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include "Core/Occupancy.h"
+
+namespace Vectorizer
+{
+    static constexpr int fineBlockSize = 8;   // one byte of a mask word
+    static constexpr int coarseRatio = 8;     // fine blocks per coarse block side
+
+    static BlockState combine(BlockState a, BlockState b)
+    {
+        return a == b ? a : BlockState::Mixed;
+    }
+
+    static OccupancyLevel buildFineLevel(const Mask& mask)
+    {
+        OccupancyLevel level;
+        level.blockSize = fineBlockSize;
+        level.columns = (mask.width + fineBlockSize - 1) / fineBlockSize;
+        level.rows = (mask.height + fineBlockSize - 1) / fineBlockSize;
+        level.states.resize(static_cast<size_t>(level.columns) * level.rows);
+
+        // Bits of the last block column that lie inside the mask.
+        const int tailWidth = mask.width - (level.columns - 1) * fineBlockSize;
+        const unsigned tailBits = (1u << tailWidth) - 1;
+
+        List<unsigned> anySolid(level.columns), allSolid(level.columns);
+        for (int blockY = 0; blockY < level.rows; ++blockY)
+        {
+            std::fill(anySolid.begin(), anySolid.end(), 0u);
+            std::fill(allSolid.begin(), allSolid.end(), 0xFFu);
+            const int endY = std::min(mask.height, (blockY + 1) * fineBlockSize);
+            for (int y = blockY * fineBlockSize; y < endY; ++y)
+            {
+                const std::uint64_t* row = mask.bits.data() + static_cast<size_t>(y) * mask.wordsPerRow;
+                for (int blockX = 0; blockX < level.columns; ++blockX)
+                {
+                    unsigned byte = static_cast<unsigned>(row[blockX >> 3] >> ((blockX & 7) * 8)) & 0xFFu;
+                    anySolid[blockX] |= byte;
+                    allSolid[blockX] &= byte;
+                }
+            }
+            for (int blockX = 0; blockX < level.columns; ++blockX)
+            {
+                const unsigned valid = blockX == level.columns - 1 ? tailBits : 0xFFu;
+                BlockState state = BlockState::Mixed;
+                if ((anySolid[blockX] & valid) == 0)
+                {
+                    state = BlockState::Empty;
+                }
+                else if ((allSolid[blockX] & valid) == valid)
+                {
+                    state = BlockState::Full;
+                }
+                level.states[static_cast<size_t>(blockY) * level.columns + blockX] = state;
+            }
+        }
+        return level;
+    }
+
+    static OccupancyLevel buildCoarseLevel(const OccupancyLevel& fine)
+    {
+        OccupancyLevel level;
+        level.blockSize = fine.blockSize * coarseRatio;
+        level.columns = (fine.columns + coarseRatio - 1) / coarseRatio;
+        level.rows = (fine.rows + coarseRatio - 1) / coarseRatio;
+        level.states.resize(static_cast<size_t>(level.columns) * level.rows);
+        for (int blockY = 0; blockY < level.rows; ++blockY)
+        {
+            for (int blockX = 0; blockX < level.columns; ++blockX)
+            {
+                const int endY = std::min(fine.rows, (blockY + 1) * coarseRatio);
+                const int endX = std::min(fine.columns, (blockX + 1) * coarseRatio);
+                BlockState state = fine.states[static_cast<size_t>(blockY * coarseRatio) * fine.columns + blockX * coarseRatio];
+                for (int y = blockY * coarseRatio; y < endY && state != BlockState::Mixed; ++y)
+                {
+                    for (int x = blockX * coarseRatio; x < endX; ++x)
+                    {
+                        state = combine(state, fine.states[static_cast<size_t>(y) * fine.columns + x]);
+                    }
+                }
+                level.states[static_cast<size_t>(blockY) * level.columns + blockX] = state;
+            }
+        }
+        return level;
+    }
+
+    Occupancy buildOccupancy(const Mask& mask)
+    {
+        Occupancy occupancy;
+        if (mask.width <= 0 || mask.height <= 0)
+        {
+            return occupancy;
+        }
+        occupancy.levels.push_back(buildFineLevel(mask));
+        occupancy.levels.push_back(buildCoarseLevel(occupancy.levels.front()));
+        return occupancy;
+    }
+}
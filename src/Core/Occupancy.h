@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include "Core/Mask.h"
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    enum class BlockState : std::uint8_t { Empty, Full, Mixed };
+
+    // Any-solid / all-solid summary of a mask in square blocks of blockSize pixels.
+    struct OccupancyLevel {
+        int blockSize = 0;
+        int columns = 0, rows = 0;
+        List<BlockState> states;
+
+        // Pixels outside the mask are empty, like Mask::isSolid.
+        BlockState stateOfPixel(int x, int y, int width, int height) const
+        {
+            if (x < 0 || y < 0 || x >= width || y >= height)
+            {
+                return BlockState::Empty;
+            }
+            return states[static_cast<size_t>(y / blockSize) * columns + x / blockSize];
+        }
+    };
+
+    // Occupancy pyramid over a mask, finest level first (8x8 then 64x64 blocks). Marching
+    // uses it to step over runs of cells whose four corners are known to agree.
+    struct Occupancy {
+        List<OccupancyLevel> levels;
+    };
+
+    Occupancy buildOccupancy(const Mask& mask);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include "Vectorizer/Executor.h"
+
+namespace Vectorizer
+{
+    // Runs body(i) for every i in [0, count). The calling thread takes part in the loop and
+    // only waits for iterations already running elsewhere, so it is safe to call from inside
+    // an executor task. A null executor runs the loop serially.
+    template<typename Body>
+    void parallelFor(Executor* pool, size_t count, Body&& body)
+    {
+        if (!pool || count < 2)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                body(i);
+            }
+            return;
+        }
+
+        struct State {
+            std::atomic<size_t> next{ 0 };
+            std::atomic<size_t> remaining{ 0 };
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        auto state = std::make_shared<State>();
+        state->remaining = count;
+        auto* bodyPointer = &body;
+
+        // Helpers that start after every index is claimed return without touching body,
+        // which may already be gone by then.
+        auto work = [state, bodyPointer, count]() {
+            for (size_t i = state->next++; i < count; i = state->next++)
+            {
+                (*bodyPointer)(i);
+                if (--state->remaining == 0)
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->finished.notify_all();
+                }
+            }
+        };
+
+        size_t helpers = std::min<size_t>(pool->concurrency(), count - 1);
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            pool->submit(work);
+        }
+        work();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&] { return state->remaining == 0; });
+    }
+}
@@ -0,0 +1,61 @@
+#include <algorithm>
+#include "Core/ImagePipeline.h"
+#include "Core/Simplify.h"
+#include "Vectorizer/Async.h"
+
+namespace Vectorizer
+{
+    static List<Math::Chain> coarseChains(const Mask& mask, const Options& options, const CancelFlag* cancel)
+    {
+        const int factor = std::max(1, options.progressive.coarseFactor);
+        const float tolerance = options.progressive.coarseTolerance > 0.0f
+            ? options.progressive.coarseTolerance
+            : options.tolerance * factor;
+
+        // extractChains maps the coarse chains back onto source pixels.
+        Mask coarseMask = downsampleMask(mask, factor);
+        List<Math::Chain> chains = extractChains(coarseMask, options, nullptr, cancel);
+        simplifyChains(chains, tolerance, options.simplify, nullptr, cancel);
+        return chains;
+    }
+
+    VectorizeHandle vectorizeImageProgressive(const std::string& path, const Options& options, ProgressCallback callback, Executor* executor)
+    {
+        Executor& pool = executor ? *executor : defaultExecutor();
+        auto cancelFlag = std::make_shared<std::atomic<bool>>(false);
+        auto promise = std::make_shared<std::promise<List<Math::Chain>>>();
+        VectorizeHandle handle(promise->get_future(), cancelFlag);
+
+        pool.submit([path, options, callback, cancelFlag, promise, &pool]() {
+            try
+            {
+                ImageJob job;
+                job.path = path;
+                job.cancel = cancelFlag.get();
+                decodeStage(job, options);
+
+                if (!job.finished && !job.extracted)
+                {
+                    List<Math::Chain> coarse = coarseChains(*job.mask, options, job.cancel);
+                    if (!isCancelled(job.cancel) && callback)
+                    {
+                        callback(Quality::Coarse, coarse);
+                    }
+                }
+
+                extractStage(job, options, &pool);
+                simplifyStage(job, options, &pool);
+                if (!isCancelled(job.cancel) && callback)
+                {
+                    callback(Quality::Final, job.chains);
+                }
+                promise->set_value(std::move(job.chains));
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+        });
+        return handle;
+    }
+}
@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Core/Hash.h"
+#include "Core/Mask.h"
+#include "Core/ResultCache.h"
+
+namespace fs = std::filesystem;
+
+namespace Vectorizer
+{
+    namespace ResultCache
+    {
+        static constexpr std::uint32_t fileMagic = 0x43434556; // "VECC"
+        static constexpr std::uint32_t fileVersion = 1;
+        static constexpr const char* fileExtension = ".vcc";
+
+        static std::atomic<std::uint64_t> hitCount{ 0 };
+        static std::atomic<std::uint64_t> missCount{ 0 };
+        static std::atomic<std::uint64_t> evictionCount{ 0 };
+        static std::atomic<std::uint64_t> tempCounter{ 0 };
+
+        // Every option that changes the produced chains must be folded in here,
+        // otherwise stale entries would be returned for different settings.
+        static std::uint64_t hashOptions(const Options& options)
+        {
+            std::uint64_t hash = Hash::mix(fileVersion);
+            hash = Hash::combine(hash, Hash::floatBits(options.tolerance));
+            hash = Hash::combine(hash, static_cast<std::uint64_t>(clampDownsampleFactor(options.downsampleFactor)));
+            hash = Hash::combine(hash, options.simplify.closedLoops ? 1 : 0);
+            hash = Hash::combine(hash, static_cast<std::uint64_t>(options.simplify.method));
+            hash = Hash::combine(hash, options.simplify.maxVerticesPerChain);
+            hash = Hash::combine(hash, options.simplify.maxVerticesPerImage);
+            hash = Hash::combine(hash, options.simplify.preserveTopology ? 1 : 0);
+            hash = Hash::combine(hash, options.components.enabled ? 1 : 0);
+            hash = Hash::combine(hash, options.components.minPixels);
+            hash = Hash::combine(hash, options.filter.minPoints);
+            hash = Hash::combine(hash, Hash::floatBits(options.filter.minArea));
+            hash = Hash::combine(hash, Hash::floatBits(options.filter.minSize));
+            hash = Hash::combine(hash, options.filter.maxChains);
+            return hash;
+        }
+
+        static fs::path entryPath(const CacheOptions& cache, std::uint64_t key)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+            return fs::path(cache.directory) / (std::string(name) + fileExtension);
+        }
+
+        template<typename T>
+        static void writeValue(std::ofstream& out, const T& value)
+        {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T>
+        static bool readValue(std::ifstream& in, T& value)
+        {
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+
+        // What is known about one cache directory: its entries from least to most recently
+        // used and their total size. The directory is listed once, on first use; after that
+        // the index is kept up to date and the filesystem is only touched to evict.
+        struct DirectoryIndex {
+            struct Entry {
+                std::uintmax_t size = 0;
+                std::list<std::string>::iterator lruPosition;
+            };
+            std::list<std::string> lruOrder; // least recently used first
+            Dictionary<std::string, Entry> entries;
+            std::uintmax_t totalBytes = 0;
+        };
+
+        static std::mutex indexMutex;
+        static Dictionary<std::string, DirectoryIndex> indexes;
+
+        // Callers hold indexMutex.
+        static DirectoryIndex& indexFor(const CacheOptions& cache)
+        {
+            auto found = indexes.find(cache.directory);
+            if (found != indexes.end())
+            {
+                return found->second;
+            }
+            DirectoryIndex& index = indexes[cache.directory];
+
+            struct Listed {
+                std::string name;
+                fs::file_time_type lastUse;
+                std::uintmax_t size;
+            };
+            List<Listed> listed;
+            std::error_code error;
+            for (const auto& item : fs::directory_iterator(cache.directory, error))
+            {
+                if (!item.is_regular_file(error) || item.path().extension() != fileExtension)
+                {
+                    continue;
+                }
+                listed.push_back({ item.path().filename().string(), item.last_write_time(error), item.file_size(error) });
+            }
+            std::sort(listed.begin(), listed.end(), [](const Listed& a, const Listed& b) {
+                return a.lastUse < b.lastUse;
+            });
+            for (const Listed& entry : listed)
+            {
+                index.lruOrder.push_back(entry.name);
+                index.entries[entry.name] = { entry.size, std::prev(index.lruOrder.end()) };
+                index.totalBytes += entry.size;
+            }
+            return index;
+        }
+
+        // Callers hold indexMutex.
+        static void forget(DirectoryIndex& index, const std::string& name)
+        {
+            auto found = index.entries.find(name);
+            if (found == index.entries.end())
+            {
+                return;
+            }
+            index.totalBytes -= found->second.size;
+            index.lruOrder.erase(found->second.lruPosition);
+            index.entries.erase(found);
+        }
+
+        // Records an entry as the most recently used one. Callers hold indexMutex.
+        static void touch(DirectoryIndex& index, const std::string& name, std::uintmax_t size)
+        {
+            forget(index, name);
+            index.lruOrder.push_back(name);
+            index.entries[name] = { size, std::prev(index.lruOrder.end()) };
+            index.totalBytes += size;
+        }
+
+        // Callers hold indexMutex.
+        static void evict(const CacheOptions& cache, DirectoryIndex& index)
+        {
+            std::error_code error;
+            while (index.totalBytes > cache.maxBytes && !index.lruOrder.empty())
+            {
+                const std::string name = index.lruOrder.front();
+                forget(index, name);
+                if (fs::remove(fs::path(cache.directory) / name, error))
+                {
+                    evictionCount++;
+                }
+            }
+        }
+
+        std::uint64_t makeKey(const List<unsigned char>& fileBytes, const Options& options)
+        {
+            std::uint64_t contentHash = Hash::bytes(fileBytes.data(), fileBytes.size());
+            return Hash::combine(contentHash, hashOptions(options));
+        }
+
+        bool load(const CacheOptions& cache, std::uint64_t key, List<Math::Chain>& outChains)
+        {
+            fs::path path = entryPath(cache, key);
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+            {
+                missCount++;
+                return false;
+            }
+
+            // Counts are checked against the bytes left before anything is allocated, so a
+            // damaged entry is discarded instead of requesting billions of elements.
+            std::error_code sizeError;
+            const std::uintmax_t fileSize = fs::file_size(path, sizeError);
+            auto bytesLeft = [&]() -> std::uintmax_t {
+                const std::streamoff offset = in.tellg();
+                return sizeError || offset < 0 || static_cast<std::uintmax_t>(offset) > fileSize ? 0 : fileSize - offset;
+            };
+
+            std::uint32_t magic = 0, version = 0, chainCount = 0;
+            std::uint64_t storedKey = 0;
+            bool valid = readValue(in, magic) && readValue(in, version) && readValue(in, storedKey) && readValue(in, chainCount)
+                && magic == fileMagic && version == fileVersion && storedKey == key;
+
+            List<Math::Chain> chains;
+            valid = valid && chainCount <= bytesLeft() / sizeof(std::uint32_t);
+            if (valid)
+            {
+                chains.resize(chainCount);
+                for (Math::Chain& chain : chains)
+                {
+                    std::uint32_t pointCount = 0;
+                    if (!readValue(in, pointCount) || pointCount > bytesLeft() / sizeof(Math::Point))
+                    {
+                        valid = false;
+                        break;
+                    }
+                    chain.resize(pointCount);
+                    if (!in.read(reinterpret_cast<char*>(chain.data()), pointCount * sizeof(Math::Point)))
+                    {
+                        valid = false;
+                        break;
+                    }
+                }
+            }
+            in.close();
+
+            std::error_code error;
+            if (!valid)
+            {
+                std::cerr << "Warning: discarding corrupt cache entry " << path << std::endl;
+                fs::remove(path, error);
+                std::lock_guard<std::mutex> lock(indexMutex);
+                forget(indexFor(cache), path.filename().string());
+                missCount++;
+                return false;
+            }
+
+            // The modification time carries the use order over to the next process.
+            fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+            {
+                std::lock_guard<std::mutex> lock(indexMutex);
+                touch(indexFor(cache), path.filename().string(), sizeError ? 0 : fileSize);
+            }
+            hitCount++;
+            outChains = std::move(chains);
+            return true;
+        }
+
+        void store(const CacheOptions& cache, std::uint64_t key, const List<Math::Chain>& chains)
+        {
+            std::error_code error;
+            fs::create_directories(cache.directory, error);
+
+            fs::path path = entryPath(cache, key);
+            // Every writer gets its own temporary file, so two tasks storing the same key never
+            // write into one file.
+            fs::path tempPath = path;
+            tempPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()))
+                + "." + std::to_string(tempCounter++) + ".tmp";
+            std::uintmax_t size = 0;
+            {
+                std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+                if (!out)
+                {
+                    std::cerr << "Warning: can't write cache entry " << path << std::endl;
+                    return;
+                }
+                writeValue(out, fileMagic);
+                writeValue(out, fileVersion);
+                writeValue(out, key);
+                writeValue(out, static_cast<std::uint32_t>(chains.size()));
+                for (const Math::Chain& chain : chains)
+                {
+                    writeValue(out, static_cast<std::uint32_t>(chain.size()));
+                    out.write(reinterpret_cast<const char*>(chain.data()), chain.size() * sizeof(Math::Point));
+                }
+                size = static_cast<std::uintmax_t>(out.tellp());
+            }
+            // Rename last so concurrent readers never observe a half-written entry.
+            fs::rename(tempPath, path, error);
+            if (error)
+            {
+                fs::remove(tempPath, error);
+                return;
+            }
+            std::lock_guard<std::mutex> lock(indexMutex);
+            DirectoryIndex& index = indexFor(cache);
+            touch(index, path.filename().string(), size);
+            evict(cache, index);
+        }
+
+        CacheStats stats()
+        {
+            CacheStats result;
+            result.hits = hitCount.load();
+            result.misses = missCount.load();
+            result.evictions = evictionCount.load();
+            return result;
+        }
+    }
+}
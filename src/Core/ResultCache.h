@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include "Vectorizer/Vectorizer.h"
+
+namespace Vectorizer
+{
+    // On-disk cache of final chains, keyed by the image file contents and every option
+    // that affects the output. Entries are small binary files in CacheOptions::directory.
+    namespace ResultCache
+    {
+        std::uint64_t makeKey(const List<unsigned char>& fileBytes, const Options& options);
+
+        bool load(const CacheOptions& cache, std::uint64_t key, List<Math::Chain>& outChains);
+        void store(const CacheOptions& cache, std::uint64_t key, const List<Math::Chain>& chains);
+
+        CacheStats stats();
+    }
+}
@@ -0,0 +1,70 @@
+#include <cmath>
+#include "Core/Simplify.h"
+
+namespace Vectorizer
+{
+    StreamingSimplifier::StreamingSimplifier(float tolerance, Math::Chain& out)
+        : tolerance(tolerance), out(out)
+    {
+    }
+
+    void StreamingSimplifier::push(const Math::Point& point)
+    {
+        if (state == State::Empty)
+        {
+            out.push_back(point);
+            anchor = point;
+            state = State::Anchored;
+            return;
+        }
+        if (state == State::Anchored)
+        {
+            if (point == anchor)
+            {
+                return;
+            }
+            direction = point;
+            previous = point;
+            state = State::Running;
+            return;
+        }
+
+        // Distance from the line through the anchor and the first point after it.
+        Math::Point axis = direction - anchor;
+        Math::Point offset = point - anchor;
+        float cross = axis.x * offset.y - axis.y * offset.x;
+        float lengthSquared = axis.x * axis.x + axis.y * axis.y;
+        if (cross * cross > tolerance * tolerance * lengthSquared)
+        {
+            out.push_back(previous);
+            anchor = previous;
+            direction = point;
+        }
+        previous = point;
+    }
+
+    void StreamingSimplifier::finish()
+    {
+        if (state == State::Running)
+        {
+            out.push_back(previous);
+        }
+        state = State::Empty;
+    }
+
+    void simplifyReumannWitkam(Math::Chain& chain, float tolerance)
+    {
+        if (chain.size() < 3)
+        {
+            return;
+        }
+        Math::Chain simplified;
+        StreamingSimplifier simplifier(tolerance, simplified);
+        for (const Math::Point& point : chain)
+        {
+            simplifier.push(point);
+        }
+        simplifier.finish();
+        chain = std::move(simplified);
+    }
+}
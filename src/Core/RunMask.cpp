@@ -0,0 +1,64 @@
+#include "Core/Bits.h"
+#include "Core/RunMask.h"
+
+namespace Vectorizer
+{
+    RunMask encodeRuns(const Mask& mask)
+    {
+        RunMask result;
+        result.width = mask.width;
+        result.height = mask.height;
+        result.rowStarts.reserve(static_cast<size_t>(mask.height) + 1);
+        result.rowStarts.push_back(0);
+        for (int y = 0; y < mask.height; ++y)
+        {
+            const std::uint64_t* row = mask.bits.data() + static_cast<size_t>(y) * mask.wordsPerRow;
+            bool inRun = false;
+            for (int word = 0; word < mask.wordsPerRow; ++word)
+            {
+                // Flip the word while inside a run so the next transition is always a set bit.
+                std::uint64_t pending = inRun ? ~row[word] : row[word];
+                int consumed = 0;
+                while (consumed < 64)
+                {
+                    std::uint64_t remaining = consumed ? pending >> consumed : pending;
+                    if (remaining == 0)
+                    {
+                        break;
+                    }
+                    consumed += Bits::countTrailingZeros(remaining);
+                    const int x = word * 64 + consumed;
+                    if (inRun)
+                    {
+                        result.runs.back().end = x;
+                    }
+                    else
+                    {
+                        result.runs.push_back({ x, mask.width });
+                    }
+                    inRun = !inRun;
+                    pending = ~pending;
+                }
+            }
+            result.rowStarts.push_back(result.runs.size());
+        }
+        return result;
+    }
+
+    size_t countRuns(const Mask& mask)
+    {
+        size_t count = 0;
+        for (int y = 0; y < mask.height; ++y)
+        {
+            const std::uint64_t* row = mask.bits.data() + static_cast<size_t>(y) * mask.wordsPerRow;
+            std::uint64_t carry = 0; // top bit of the previous word, moved to bit 0
+            for (int word = 0; word < mask.wordsPerRow; ++word)
+            {
+                // A run starts at every solid pixel whose left neighbour is empty.
+                count += Bits::popCount(row[word] & ~((row[word] << 1) | carry));
+                carry = row[word] >> 63;
+            }
+        }
+        return count;
+    }
+}
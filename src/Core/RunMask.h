@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Core/Mask.h"
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    // Solid pixels [begin, end) of one mask row.
+    struct Run {
+        int begin = 0, end = 0;
+    };
+
+    // Run-length encoded mask: the maximal solid runs of each row, left to right. Tile-based
+    // and vector-drawn masks are often hundreds of times smaller in this form.
+    struct RunMask {
+        int width = 0, height = 0;
+        List<Run> runs;
+        List<size_t> rowStarts; // runs of row y are [rowStarts[y], rowStarts[y + 1])
+
+        const Run* rowBegin(int y) const { return runs.data() + rowStarts[y]; }
+        const Run* rowEnd(int y) const { return runs.data() + rowStarts[y + 1]; }
+    };
+
+    RunMask encodeRuns(const Mask& mask);
+
+    // Number of runs encodeRuns would produce, counted with popcounts and no allocation.
+    size_t countRuns(const Mask& mask);
+}
@@ -0,0 +1,180 @@
+#include "Core/Simplify.h"
+#include "Core/Parallel.h"
+
+namespace Vectorizer
+{
+    static constexpr size_t minParallelLoopPoints = 4096;
+
+    void simplifyRecursive(const Math::Chain& originalChain, size_t startIndex, size_t endIndex, float tolerance, Math::Chain& outChain, const CancelFlag* cancel)
+    {
+        if (isCancelled(cancel))
+        {
+            return;
+        }
+        float maxDistance = 0.0f;
+        size_t farthestIndex = startIndex;
+        Math::Segment segment = { originalChain[startIndex], originalChain[endIndex] };
+
+        for (size_t i = startIndex + 1; i < endIndex; ++i)
+        {
+            float currentDistance = pointToSegmentDistance(segment, originalChain[i]);
+            if (currentDistance > maxDistance)
+            {
+                maxDistance = currentDistance;
+                farthestIndex = i;
+            }
+        }
+
+        if (maxDistance > tolerance)
+        {
+            simplifyRecursive(originalChain, startIndex, farthestIndex, tolerance, outChain, cancel);
+            simplifyRecursive(originalChain, farthestIndex, endIndex, tolerance, outChain, cancel);
+        }
+        else
+        {
+            outChain.push_back(originalChain[endIndex]);
+        }
+    }
+
+    //Ramer-Douglas-Peucker
+    Math::Chain simplifyChain(Math::Chain& chain, float tolerance, const CancelFlag* cancel)
+    {
+        if (chain.size() < 3) {
+            return chain;
+        }
+
+        Math::Chain simplifiedChain;
+        simplifiedChain.push_back(chain.front());
+
+        simplifyRecursive(chain, 0, chain.size() - 1, tolerance, simplifiedChain, cancel);
+        chain = simplifiedChain;
+        return chain;
+    }
+
+    bool isClosed(const Math::Chain& chain)
+    {
+        return chain.size() >= 3 && chain.front() == chain.back();
+    }
+
+    void simplifyLoopHalves(Math::Chain& chain, Executor* pool, const std::function<void(Math::Chain&)>& simplifyOpen)
+    {
+        // The loop without its repeated closing vertex.
+        const size_t count = chain.size() - 1;
+
+        size_t first = 0;
+        for (size_t i = 1; i < count; ++i)
+        {
+            if (chain[i].x < chain[first].x || (chain[i].x == chain[first].x && chain[i].y < chain[first].y))
+            {
+                first = i;
+            }
+        }
+        size_t second = first;
+        float farthest = 0.0f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Math::Point delta = chain[i] - chain[first];
+            float distance = delta.x * delta.x + delta.y * delta.y;
+            if (distance > farthest)
+            {
+                farthest = distance;
+                second = i;
+            }
+        }
+
+        // Both halves include the two anchors, walking the loop from first to second and back.
+        Math::Chain halves[2];
+        const size_t secondOffset = (second + count - first) % count;
+        for (size_t step = 0; step <= count; ++step)
+        {
+            const Math::Point& point = chain[(first + step) % count];
+            if (step <= secondOffset)
+            {
+                halves[0].push_back(point);
+            }
+            if (step >= secondOffset)
+            {
+                halves[1].push_back(point);
+            }
+        }
+        // Splitting small loops across threads costs more than it saves.
+        Executor* halvesPool = count >= minParallelLoopPoints ? pool : nullptr;
+        parallelFor(halvesPool, 2, [&](size_t half) {
+            simplifyOpen(halves[half]);
+        });
+
+        chain = std::move(halves[0]);
+        chain.insert(chain.end(), halves[1].begin() + 1, halves[1].end());
+    }
+
+    void simplifyClosedChain(Math::Chain& chain, float tolerance, Executor* pool, const CancelFlag* cancel)
+    {
+        if (!isClosed(chain) || chain.size() < 4)
+        {
+            simplifyChain(chain, tolerance, cancel);
+            return;
+        }
+        simplifyLoopHalves(chain, pool, [&](Math::Chain& half) {
+            simplifyChain(half, tolerance, cancel);
+        });
+    }
+
+    void simplifyContour(Math::Chain& chain, float tolerance, const SimplifyOptions& settings, Executor* pool, const CancelFlag* cancel)
+    {
+        switch (settings.method)
+        {
+        case SimplifyMethod::ReumannWitkam:
+            if (settings.closedLoops && isClosed(chain) && chain.size() >= 4)
+            {
+                simplifyLoopHalves(chain, pool, [&](Math::Chain& half) {
+                    simplifyReumannWitkam(half, tolerance);
+                });
+            }
+            else
+            {
+                simplifyReumannWitkam(chain, tolerance);
+            }
+            break;
+        case SimplifyMethod::ImaiIri:
+            if (settings.closedLoops && isClosed(chain) && chain.size() >= 4)
+            {
+                simplifyLoopHalves(chain, pool, [&](Math::Chain& half) {
+                    simplifyImaiIri(half, tolerance, cancel);
+                });
+            }
+            else
+            {
+                simplifyImaiIri(chain, tolerance, cancel);
+            }
+            break;
+        case SimplifyMethod::VisvalingamWhyatt:
+            simplifyVisvalingam(chain, tolerance, settings.closedLoops, cancel);
+            break;
+        case SimplifyMethod::RamerDouglasPeucker:
+            if (settings.closedLoops)
+            {
+                simplifyClosedChain(chain, tolerance, pool, cancel);
+            }
+            else
+            {
+                simplifyChain(chain, tolerance, cancel);
+            }
+            break;
+        }
+    }
+
+    void simplifyChains(List<Math::Chain>& chains, float tolerance, const SimplifyOptions& settings, Executor* pool, const CancelFlag* cancel)
+    {
+        if (settings.preserveTopology)
+        {
+            simplifyPreservingTopology(chains, tolerance, cancel);
+            return;
+        }
+        parallelFor(pool, chains.size(), [&](size_t i) {
+            if (!isCancelled(cancel))
+            {
+                simplifyContour(chains[i], tolerance, settings, pool, cancel);
+            }
+        });
+    }
+}
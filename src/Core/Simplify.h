@@ -0,0 +1,76 @@
+#pragma once
+
+#include <functional>
+#include "Core/Cancel.h"
+#include "Vectorizer/Math.h"
+#include "Vectorizer/Executor.h"
+#include "Vectorizer/Options.h"
+#include "Vectorizer/Util.h"
+
+namespace Vectorizer
+{
+    //Ramer-Douglas-Peucker, in place
+    Math::Chain simplifyChain(Math::Chain& chain, float tolerance, const CancelFlag* cancel = nullptr);
+
+    // For chains that end where they start: splits the loop at its leftmost vertex and the
+    // vertex farthest from it, and simplifies both halves (in parallel on the pool). The
+    // result starts and ends at the first anchor instead of the arbitrary tracing seam.
+    void simplifyClosedChain(Math::Chain& chain, float tolerance, Executor* pool = nullptr, const CancelFlag* cancel = nullptr);
+
+    // The anchor split behind simplifyClosedChain, running any open-chain simplifier on the
+    // halves. The chain must be closed with at least four points.
+    void simplifyLoopHalves(Math::Chain& chain, Executor* pool, const std::function<void(Math::Chain&)>& simplifyOpen);
+
+    // Imai-Iri: the polyline with the fewest vertices whose every skipped point lies within
+    // tolerance of its segment, found as a shortest path over the valid shortcuts. Shortcuts are
+    // tested with Chan-Chin tangent cones, and a scan stops once its cone is empty. Meant for
+    // baking, as it can approach O(n^2) on long smooth chains.
+    void simplifyImaiIri(Math::Chain& chain, float tolerance, const CancelFlag* cancel = nullptr);
+
+    // Visvalingam-Whyatt: repeatedly drops the vertex spanning the smallest triangle with its
+    // neighbours while that area is below tolerance squared. O(n log n) through an indexed heap.
+    // With closedLoops, chains that end where they start are treated as rings.
+    void simplifyVisvalingam(Math::Chain& chain, float tolerance, bool closedLoops, const CancelFlag* cancel = nullptr);
+
+    // Reumann-Witkam: a single O(n) pass that keeps a vertex whenever the next point strays
+    // more than tolerance from the line through the last kept vertex and its successor.
+    // Points are fed one at a time, so it can run while a chain is being traced.
+    class StreamingSimplifier
+    {
+    public:
+        StreamingSimplifier(float tolerance, Math::Chain& out);
+
+        void push(const Math::Point& point);
+        void finish(); // flushes the last point; the simplifier can then start a new chain
+
+    private:
+        enum class State { Empty, Anchored, Running };
+
+        float tolerance;
+        Math::Chain& out;
+        State state = State::Empty;
+        Math::Point anchor{}, direction{}, previous{};
+    };
+
+    void simplifyReumannWitkam(Math::Chain& chain, float tolerance);
+
+    // Picks the simplification the settings ask for.
+    void simplifyContour(Math::Chain& chain, float tolerance, const SimplifyOptions& settings, Executor* pool = nullptr, const CancelFlag* cancel = nullptr);
+
+    // Ramer-Douglas-Peucker over all chains at once that only takes a shortcut when it doesn't
+    // cross or touch any other current segment and no other current vertex lies between it
+    // and the span it replaces, both found through a uniform grid over the image.
+    // Chains therefore never gain self-intersections or cross each other, and loops keep at
+    // least three vertices. Runs serially, as every accepted shortcut updates the grid.
+    void simplifyPreservingTopology(List<Math::Chain>& chains, float tolerance, const CancelFlag* cancel = nullptr);
+
+    void simplifyChains(List<Math::Chain>& chains, float tolerance, const SimplifyOptions& settings, Executor* pool = nullptr, const CancelFlag* cancel = nullptr);
+
+    // Removes the least important vertices (smallest triangle with their neighbours) across
+    // all chains in one priority-queue pass, until no chain has more than maxPerChain vertices
+    // and all of them together have at most maxTotal. A zero limit is no limit. Closed chains
+    // count their repeated closing vertex once and keep at least three.
+    void applyVertexBudget(List<Math::Chain>& chains, size_t maxPerChain, size_t maxTotal);
+
+    bool isClosed(const Math::Chain& chain);
+}
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "Vectorizer/ThreadPool.h"
+
+namespace Vectorizer
+{
+    struct ThreadPool::Impl {
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        List<unique<Queue>> queues;
+        List<std::thread> threads;
+        std::mutex sleepMutex;
+        std::condition_variable wake;
+        std::atomic<size_t> pending{ 0 };
+        std::atomic<unsigned> nextQueue{ 0 };
+        bool stopping = false;
+
+        bool tryPop(unsigned self, std::function<void()>& task);
+        void run(unsigned self);
+    };
+
+    static thread_local const void* currentPool = nullptr; // Impl of the pool running this thread
+    static thread_local unsigned currentWorker = 0;
+
+    bool ThreadPool::Impl::tryPop(unsigned self, std::function<void()>& task)
+    {
+        // Own deque is used LIFO for cache locality, victims are robbed FIFO.
+        {
+            Queue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < queues.size(); ++offset)
+        {
+            Queue& victim = *queues[(self + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::Impl::run(unsigned self)
+    {
+        currentPool = this;
+        currentWorker = self;
+        std::function<void()> task;
+        while (true)
+        {
+            if (tryPop(self, task))
+            {
+                pending--;
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return stopping || pending > 0; });
+            if (stopping && pending == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    ThreadPool::ThreadPool(unsigned threadCount)
+        : impl(std::make_unique<Impl>())
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < threadCount; ++i)
+        {
+            impl->queues.push_back(std::make_unique<Impl::Queue>());
+        }
+        for (unsigned i = 0; i < threadCount; ++i)
+        {
+            impl->threads.emplace_back([this, i] { impl->run(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(impl->sleepMutex);
+            impl->stopping = true;
+        }
+        impl->wake.notify_all();
+        for (std::thread& thread : impl->threads)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        unsigned index = currentPool == impl.get()
+            ? currentWorker
+            : impl->nextQueue++ % static_cast<unsigned>(impl->queues.size());
+        {
+            Impl::Queue& queue = *impl->queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(impl->sleepMutex);
+            impl->pending++;
+        }
+        impl->wake.notify_one();
+    }
+
+    unsigned ThreadPool::concurrency() const
+    {
+        return threadCount();
+    }
+
+    unsigned ThreadPool::threadCount() const
+    {
+        return static_cast<unsigned>(impl->threads.size());
+    }
+
+    ThreadPool& ThreadPool::shared()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    static std::atomic<Executor*> injectedExecutor{ nullptr };
+
+    void setDefaultExecutor(Executor* executor)
+    {
+        injectedExecutor = executor;
+    }
+
+    Executor& defaultExecutor()
+    {
+        Executor* executor = injectedExecutor.load();
+        return executor ? *executor : ThreadPool::shared();
+    }
+}
@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <cmath>
+#include "Core/Simplify.h"
+
+namespace Vectorizer
+{
+    namespace
+    {
+        struct GridSegment {
+            Math::Point start, end;
+            size_t chain, from, to; // vertex indices of the endpoints in their original chain
+            bool alive;
+        };
+
+        // Orientation in double precision: exact for lattice coordinates of any mask size.
+        double orientation(const Math::Point& a, const Math::Point& b, const Math::Point& c)
+        {
+            return (static_cast<double>(b.x) - a.x) * (static_cast<double>(c.y) - a.y)
+                - (static_cast<double>(b.y) - a.y) * (static_cast<double>(c.x) - a.x);
+        }
+
+        bool samePoint(const Math::Point& a, const Math::Point& b)
+        {
+            return a.x == b.x && a.y == b.y;
+        }
+
+        // Collinear c strictly inside segment ab.
+        bool inside(const Math::Point& a, const Math::Point& b, const Math::Point& c)
+        {
+            return !samePoint(c, a) && !samePoint(c, b)
+                && std::min(a.x, b.x) <= c.x && c.x <= std::max(a.x, b.x)
+                && std::min(a.y, b.y) <= c.y && c.y <= std::max(a.y, b.y);
+        }
+
+        // Crossing, touching or doubling back; meeting at a shared endpoint is allowed.
+        bool conflict(const Math::Point& a, const Math::Point& b, const Math::Point& c, const Math::Point& d)
+        {
+            if ((samePoint(a, c) && samePoint(b, d)) || (samePoint(a, d) && samePoint(b, c)))
+            {
+                return true;
+            }
+            const double o1 = orientation(a, b, c), o2 = orientation(a, b, d);
+            const double o3 = orientation(c, d, a), o4 = orientation(c, d, b);
+            if (((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) && ((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0)))
+            {
+                return true;
+            }
+            return (o1 == 0 && inside(a, b, c)) || (o2 == 0 && inside(a, b, d))
+                || (o3 == 0 && inside(c, d, a)) || (o4 == 0 && inside(c, d, b));
+        }
+
+        // Uniform grid over every segment of the image, original or already simplified.
+        class SegmentGrid
+        {
+        public:
+            explicit SegmentGrid(const List<Math::Chain>& chains)
+            {
+                size_t segmentCount = 0;
+                float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+                for (const Math::Chain& chain : chains)
+                {
+                    segmentCount += chain.empty() ? 0 : chain.size() - 1;
+                    for (const Math::Point& point : chain)
+                    {
+                        minX = std::min(minX, point.x);
+                        minY = std::min(minY, point.y);
+                        maxX = std::max(maxX, point.x);
+                        maxY = std::max(maxY, point.y);
+                    }
+                }
+                if (segmentCount == 0)
+                {
+                    return;
+                }
+                // Roughly one segment per cell.
+                const float width = maxX - minX + 1.0f, height = maxY - minY + 1.0f;
+                cellSize = std::max(1.0f, std::sqrt(width * height / segmentCount));
+                originX = minX;
+                originY = minY;
+                columns = std::min(maxCells, static_cast<int>(width / cellSize) + 1);
+                rows = std::min(maxCells, static_cast<int>(height / cellSize) + 1);
+                cells.resize(static_cast<size_t>(columns) * rows);
+                segments.reserve(segmentCount);
+            }
+
+            size_t insert(const GridSegment& segment)
+            {
+                const size_t id = segments.size();
+                segments.push_back(segment);
+                visitCells(segment.start, segment.end, [&](List<size_t>& cell) {
+                    cell.push_back(id);
+                });
+                stamps.push_back(0);
+                return id;
+            }
+
+            size_t size() const { return segments.size(); }
+
+            void remove(size_t id)
+            {
+                segments[id].alive = false;
+            }
+
+            // True when a live segment other than the ignored ones conflicts with a -> b.
+            template<typename Ignore>
+            bool anyConflict(const Math::Point& a, const Math::Point& b, Ignore&& ignore)
+            {
+                return anyLiveSegment(a, b, [&](const GridSegment& segment) {
+                    return !ignore(segment) && conflict(a, b, segment.start, segment.end);
+                });
+            }
+
+            // True when test holds for a live segment in a cell overlapping the box spanned by
+            // corners a and b. Each segment is tested once.
+            template<typename Test>
+            bool anyLiveSegment(const Math::Point& a, const Math::Point& b, Test&& test)
+            {
+                bool found = false;
+                currentStamp++;
+                visitCells(a, b, [&](List<size_t>& cell) {
+                    for (size_t id : cell)
+                    {
+                        if (found || stamps[id] == currentStamp)
+                        {
+                            continue;
+                        }
+                        stamps[id] = currentStamp;
+                        const GridSegment& segment = segments[id];
+                        if (segment.alive && test(segment))
+                        {
+                            found = true;
+                        }
+                    }
+                });
+                return found;
+            }
+
+        private:
+            static constexpr int maxCells = 4096;
+
+            int cellColumn(float x) const { return std::clamp(static_cast<int>((x - originX) / cellSize), 0, columns - 1); }
+            int cellRow(float y) const { return std::clamp(static_cast<int>((y - originY) / cellSize), 0, rows - 1); }
+
+            template<typename Visit>
+            void visitCells(const Math::Point& a, const Math::Point& b, Visit&& visit)
+            {
+                const int beginX = cellColumn(std::min(a.x, b.x)), endX = cellColumn(std::max(a.x, b.x));
+                const int beginY = cellRow(std::min(a.y, b.y)), endY = cellRow(std::max(a.y, b.y));
+                for (int y = beginY; y <= endY; ++y)
+                {
+                    for (int x = beginX; x <= endX; ++x)
+                    {
+                        visit(cells[static_cast<size_t>(y) * columns + x]);
+                    }
+                }
+            }
+
+            float cellSize = 1.0f, originX = 0.0f, originY = 0.0f;
+            int columns = 0, rows = 0;
+            List<List<size_t>> cells;
+            List<GridSegment> segments;
+            List<size_t> stamps;
+            size_t currentStamp = 0;
+        };
+
+        class TopologySimplifier
+        {
+        public:
+            TopologySimplifier(List<Math::Chain>& chains, float tolerance, const CancelFlag* cancel)
+                : chains(chains), tolerance(tolerance), cancel(cancel), grid(chains), firstSegment(chains.size())
+            {
+                for (size_t c = 0; c < chains.size(); ++c)
+                {
+                    firstSegment[c] = grid.size();
+                    for (size_t k = 0; k + 1 < chains[c].size(); ++k)
+                    {
+                        grid.insert({ chains[c][k], chains[c][k + 1], c, k, k + 1, true });
+                    }
+                }
+            }
+
+            void run()
+            {
+                for (size_t c = 0; c < chains.size(); ++c)
+                {
+                    if (isCancelled(cancel))
+                    {
+                        return;
+                    }
+                    Math::Chain& chain = chains[c];
+                    if (chain.size() < 3)
+                    {
+                        continue;
+                    }
+                    Math::Chain simplified;
+                    simplified.push_back(chain.front());
+                    simplifyRange(c, 0, chain.size() - 1, simplified);
+                    chain = std::move(simplified);
+                }
+            }
+
+        private:
+            // RDP that only takes a shortcut when it stays clear of every other live segment.
+            void simplifyRange(size_t c, size_t startIndex, size_t endIndex, Math::Chain& out)
+            {
+                const Math::Chain& chain = chains[c];
+                if (endIndex == startIndex + 1)
+                {
+                    out.push_back(chain[endIndex]);
+                    return;
+                }
+
+                float maxDistance = 0.0f;
+                size_t farthestIndex = startIndex;
+                Math::Segment segment = { chain[startIndex], chain[endIndex] };
+                for (size_t i = startIndex + 1; i < endIndex; ++i)
+                {
+                    float currentDistance = pointToSegmentDistance(segment, chain[i]);
+                    if (currentDistance > maxDistance)
+                    {
+                        maxDistance = currentDistance;
+                        farthestIndex = i;
+                    }
+                }
+
+                // A loop is never collapsed onto its own seam.
+                const bool wholeLoop = startIndex == 0 && endIndex == chain.size() - 1 && isClosed(chain);
+                if (maxDistance <= tolerance && !wholeLoop && shortcutIsClear(c, startIndex, endIndex))
+                {
+                    for (size_t k = startIndex; k < endIndex; ++k)
+                    {
+                        grid.remove(firstSegment[c] + k);
+                    }
+                    grid.insert({ chain[startIndex], chain[endIndex], c, startIndex, endIndex, true });
+                    out.push_back(chain[endIndex]);
+                    return;
+                }
+
+                if (farthestIndex == startIndex)
+                {
+                    farthestIndex = (startIndex + endIndex) / 2;
+                }
+                simplifyRange(c, startIndex, farthestIndex, out);
+                simplifyRange(c, farthestIndex, endIndex, out);
+            }
+
+            // Live segments never cross, so besides crossing the shortcut another segment can
+            // only be cut off by lying wholly inside the area between the span and the shortcut;
+            // its vertices then lie strictly inside that polygon.
+            bool shortcutIsClear(size_t c, size_t startIndex, size_t endIndex)
+            {
+                const Math::Chain& chain = chains[c];
+                auto replaced = [&](const GridSegment& segment) {
+                    return segment.chain == c && segment.from >= startIndex && segment.to <= endIndex;
+                };
+                if (grid.anyConflict(chain[startIndex], chain[endIndex], replaced))
+                {
+                    return false;
+                }
+
+                Math::Point low = chain[startIndex], high = chain[startIndex];
+                for (size_t i = startIndex + 1; i <= endIndex; ++i)
+                {
+                    low = { std::min(low.x, chain[i].x), std::min(low.y, chain[i].y) };
+                    high = { std::max(high.x, chain[i].x), std::max(high.y, chain[i].y) };
+                }
+                return !grid.anyLiveSegment(low, high, [&](const GridSegment& segment) {
+                    return !replaced(segment)
+                        && (insideSpan(chain, startIndex, endIndex, segment.start)
+                            || insideSpan(chain, startIndex, endIndex, segment.end));
+                });
+            }
+
+            // Point strictly inside the polygon closed by the shortcut from endIndex back to
+            // startIndex; points on its boundary are outside. Even-odd rule, so a span that
+            // winds around itself still counts each enclosed area.
+            static bool insideSpan(const Math::Chain& chain, size_t startIndex, size_t endIndex, const Math::Point& point)
+            {
+                bool inside = false;
+                for (size_t i = startIndex; i <= endIndex; ++i)
+                {
+                    const Math::Point& a = chain[i];
+                    const Math::Point& b = chain[i < endIndex ? i + 1 : startIndex];
+                    if (orientation(a, b, point) == 0
+                        && std::min(a.x, b.x) <= point.x && point.x <= std::max(a.x, b.x)
+                        && std::min(a.y, b.y) <= point.y && point.y <= std::max(a.y, b.y))
+                    {
+                        return false;
+                    }
+                    if ((a.y > point.y) != (b.y > point.y)
+                        && orientation(a, b, point) * (b.y - a.y) > 0)
+                    {
+                        inside = !inside;
+                    }
+                }
+                return inside;
+            }
+
+            List<Math::Chain>& chains;
+            float tolerance;
+            const CancelFlag* cancel;
+            SegmentGrid grid;
+            List<size_t> firstSegment;
+        };
+    }
+
+    void simplifyPreservingTopology(List<Math::Chain>& chains, float tolerance, const CancelFlag* cancel)
+    {
+        TopologySimplifier simplifier(chains, tolerance, cancel);
+        simplifier.run();
+    }
+}
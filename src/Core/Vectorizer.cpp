@@ -1,219 +1,325 @@
 #include <vector>
 #include <Vectorizer/Vectorizer.h>
+#include "Core/ChainBuilder.h"
+#include "Core/Components.h"
+#include "Core/Hierarchy.h"
+#include "Core/ImagePipeline.h"
+#include "Core/MarchingSquares.h"
+#include "Core/MaskCache.h"
+#include "Core/ResultCache.h"
+#include "Core/Simplify.h"
 #include "IO/ImageLoader.h"
-#include "Vectorizer/util.h"
+#include "Vectorizer/Util.h"
 
 namespace Vectorizer
 {
-    using EdgePair = std::pair<int, int>;
-    static const List<EdgePair> marchingSquaresLUT[16] = {
-        {},                     // Case 0: ----
-        { {0, 3} },             // Case 1: #---
-        { {1, 0} },             // Case 2: -#--
-        { {1, 3} },             // Case 3: ##--
-        { {2, 1} },             // Case 4: --#-
-        { {0, 3}, {2, 1} },     // Case 5: #-#-
-        { {2, 0} },             // Case 6: -##-
-        { {2, 3} },             // Case 7: ###-
-        { {3, 2} },             // Case 8: ---#
-        { {0, 2} },             // Case 9: #--#
-        { {1, 0}, {3, 2} },     // Case 10: -#-#
-        { {1, 2} },             // Case 11: #-##
-        { {3, 1} },             // Case 12: --##
-        { {0, 1} },             // Case 13: #.##
-        { {3, 0} },             // Case 14: -###
-        {}                      // Case 15: ####
-    };
-
-    bool isSolid(int x, int y, int width, int height, int channels, const unsigned char* data)
-    {
-        if (x < 0 || y < 0 || x >= width || y >= height)
+    void printChainsToConsole(List<Math::Chain>& chains, int imageWidth, int imageHeight, int consoleWidth)
+    {
+        if (chains.empty())
         {
-            return false;
+            std::cout << "Nessuna catena da visualizzare." << std::endl;
+            return;
         }
 
-        int index = (y * width + x) * channels;
+        int consoleHeight = static_cast<int>((static_cast<float>(imageHeight) / imageWidth) * consoleWidth * 0.5f);
 
-        return data[index] < 128;
-    }
+        std::vector<std::string> canvas(consoleHeight, std::string(consoleWidth, '.'));
 
-    void simplifyRecursive(const Math::Chain& originalChain, size_t startIndex, size_t endIndex, float tolerance, Math::Chain& outChain)
-    {
-        float maxDistance = 0.0f;
-        size_t farthestIndex = startIndex;
-        Math::Segment segment = { originalChain[startIndex], originalChain[endIndex] };
+        char drawChar = 'A';
 
-        for (size_t i = startIndex + 1; i < endIndex; ++i)
+        for (const auto& chain : chains)
         {
-            float currentDistance = pointToSegmentDistance(segment, originalChain[i]);
-            if (currentDistance > maxDistance)
+            for (const auto& point : chain)
             {
-                maxDistance = currentDistance;
-                farthestIndex = i;
+                int x = static_cast<int>((point.x / imageWidth) * consoleWidth);
+                int y = static_cast<int>((point.y / imageHeight) * consoleHeight);
+
+                if (x >= 0 && x < consoleWidth && y >= 0 && y < consoleHeight)
+                {
+                    canvas[y][x] = drawChar;
+                }
             }
+            drawChar++;
+            if (drawChar > 'Z') drawChar = 'A';
+        }
+
+        std::cout << "\n--- Visualizzazione Contorni Semplificati ---" << std::endl;
+        for (int i = 0; i < consoleHeight; ++i)
+        {
+            std::cout << canvas[i] << std::endl;
         }
+        std::cout << "---------------------------------------------\n" << std::endl;
+    }
+
+    static Executor* splitPool(const Mask& mask, const Options& options, Executor* pool)
+    {
+        size_t pixels = static_cast<size_t>(mask.width) * mask.height;
+        return pixels >= options.parallel.minSplitPixels ? pool : nullptr;
+    }
+
+    bool simplifiesWhileTracing(const Options& options)
+    {
+        const SimplifyOptions& simplify = options.simplify;
+        return simplify.method == SimplifyMethod::ReumannWitkam && !simplify.closedLoops && !simplify.preserveTopology;
+    }
+
+    ChainFilter chainFilter(const Options& options, int scale)
+    {
+        ChainFilter filter;
+        filter.minPoints = options.filter.minPoints;
+        filter.minArea = options.filter.minArea / static_cast<float>(scale * scale);
+        filter.minSize = options.filter.minSize / static_cast<float>(scale);
+        return filter;
+    }
+
+    // Chains simplified during tracing depend on the tolerance, and traced components on
+    // their filter, so neither is cached as raw.
+    static bool keepsRawChains(const Options& options)
+    {
+        return options.maskCache.enabled && options.maskCache.keepRawChains && !simplifiesWhileTracing(options)
+            && !options.components.enabled;
+    }
 
-        if (maxDistance > tolerance)
+    List<Math::Chain> extractChains(const Mask& mask, const Options& options, Executor* pool, const CancelFlag* cancel)
+    {
+        // Linking works in mask pixels, so the tolerance shrinks with the downsample factor.
+        const float streamTolerance = simplifiesWhileTracing(options) ? options.tolerance / mask.scale : 0.0f;
+        List<Math::Chain> chains;
+        if (options.components.enabled)
         {
-            simplifyRecursive(originalChain, startIndex, farthestIndex, tolerance, outChain);
-            simplifyRecursive(originalChain, farthestIndex, endIndex, tolerance, outChain);
+            Components components = labelComponents(mask, splitPool(mask, options, pool), options.parallel.bandRows);
+            chains = traceComponents(mask, components, options.components.minPixels, chainFilter(options, mask.scale), streamTolerance, splitPool(mask, options, pool), cancel);
         }
         else
         {
-            outChain.push_back(originalChain[endIndex]);
+            List<LatticeSegment> rawSegments = marchingSquares(mask, splitPool(mask, options, pool), options.parallel.bandRows, cancel);
+            chains = buildChainsFromSegments(rawSegments, cancel, streamTolerance, chainFilter(options, mask.scale));
         }
+        keepLargestChains(chains, options.filter.maxChains);
+        scaleToSource(chains, mask);
+        return chains;
     }
 
-    //Ramer-Douglas-Peucker
-    Math::Chain simplifyChain(Math::Chain& chain, float tolerance)
+    static bool abandonIfCancelled(ImageJob& job)
     {
-        if (chain.size() < 3) {
-            return chain;
+        if (!isCancelled(job.cancel))
+        {
+            return false;
         }
+        job.chains.clear();
+        job.mask = nullptr;
+        job.finished = true;
+        return true;
+    }
 
-        Math::Chain simplifiedChain;
-        simplifiedChain.push_back(chain.front());
-
-        simplifyRecursive(chain, 0, chain.size() - 1, tolerance, simplifiedChain);
-        chain = simplifiedChain;
-        return chain;
+    List<Math::Chain> vectorizeView(const ImageView& view, const Options& options, Executor* pool)
+    {
+        ImageData image{ "", view.width, view.height, view.channels, view.data };
+        if (!image.isValid() || view.width <= 0 || view.height <= 0)
+        {
+            std::cerr << "Error: invalid image view" << std::endl;
+            return List<Math::Chain>{};
+        }
+        Mask mask = thresholdImage(image, options.downsampleFactor);
+        List<Math::Chain> chains = extractChains(mask, options, pool);
+        if (!simplifiesWhileTracing(options))
+        {
+            simplifyChains(chains, options.tolerance, options.simplify, splitPool(mask, options, pool));
+        }
+        applyVertexBudget(chains, options.simplify.maxVerticesPerChain, options.simplify.maxVerticesPerImage);
+        return chains;
     }
 
-    List<Math::Chain> buildChainsFromSegments(List<Math::Segment>& segments)
+    void decodeStage(ImageJob& job, const Options& options)
     {
-        List<Math::Chain> chains = {};
-        while (segments.size() > 1)
+        if (abandonIfCancelled(job))
         {
-            Math::Chain chain = { segments.back().start, segments.back().end };
-            segments.pop_back();
-            bool foundNext = true;
-            while (foundNext)
+            return;
+        }
+        const bool useResultCache = !options.cache.directory.empty();
+        if (useResultCache)
+        {
+            if (job.fileBytes.empty())
             {
-                foundNext = false;
-                for (auto iter = segments.begin(); iter != segments.end();)
-                {
-                    if (iter->start == chain.back())
-                    {
-                        chain.push_back(iter->end);
-                        iter = segments.erase(iter);
-                        foundNext = true;
-                        break;
-                    }
-                    else
-                    {
-                        ++iter;
-                    }
-                }
+                job.fileBytes = ImageLoader::readFile(job.path);
             }
-            if (chain.size() > 20) {
-                chains.push_back(chain);
+            if (job.fileBytes.empty())
+            {
+                std::cerr << "Error: can't load image" << std::endl;
+                job.finished = true;
+                return;
+            }
+            job.resultKey = ResultCache::makeKey(job.fileBytes, options);
+            job.hasResultKey = true;
+            if (ResultCache::load(options.cache, job.resultKey, job.chains))
+            {
+                job.finished = true;
+                return;
             }
         }
-        return chains;
-    }
 
-    List<Math::Segment> marchingSquares(ImageData image)
-    {
-        List<Math::Segment> allSegments;
+        MaskCache::Entry cached;
+        if (options.maskCache.enabled)
+        {
+            job.maskKey = MaskCache::makeKey(job.path, options);
+            cached = MaskCache::lookup(job.maskKey);
+        }
+        job.mask = cached.mask;
+        if (cached.rawChains && keepsRawChains(options))
+        {
+            job.chains = *cached.rawChains;
+            job.extracted = true;
+            return;
+        }
 
-        for (int y = -1; y < image.height; ++y)
+        if (!job.mask)
         {
-            for (int x = -1; x < image.width; ++x)
+            ImageData image = job.fileBytes.empty() ? ImageLoader::loadImageData(job.path) : ImageLoader::loadImageDataFromMemory(job.path, job.fileBytes);
+            if (!image.isValid())
             {
-                bool topLeft = isSolid(x, y, image.width, image.height, image.channels, image.data);
-                bool topRight = isSolid(x + 1, y, image.width, image.height, image.channels, image.data);
-                bool bottomLeft = isSolid(x, y + 1, image.width, image.height, image.channels, image.data);
-                bool bottomRight = isSolid(x + 1, y + 1, image.width, image.height, image.channels, image.data);
-
-                int index = 0;
-                if (topLeft) index += 1;
-                if (topRight) index += 2;
-                if (bottomRight) index += 4;
-                if (bottomLeft) index += 8;
-
-                if (index == 0 || index == 15) {
-                    continue;
-                }
-                const auto& rules = marchingSquaresLUT[index];
-
-                for (const auto& rule : rules)
-                {
-                    Math::Point startPoint, endPoint;
-
-                    switch (rule.first) //starting point
-                    {
-                    case 0: startPoint = { x + 0.5f, (float)y }; break; //top
-                    case 1: startPoint = { x + 1.f, y + 0.5f }; break; //right
-                    case 2: startPoint = { x + 0.5f, y + 1.f }; break; //bottom
-                    case 3: startPoint = { (float)x, y + 0.5f }; break; //left
-                    }
-                    switch (rule.second) //ending point
-                    {
-                    case 0: endPoint = { x + 0.5f, (float)y }; break; //top
-                    case 1: endPoint = { x + 1.f, y + 0.5f }; break; //right
-                    case 2: endPoint = { x + 0.5f, y + 1.f }; break; //bottom
-                    case 3: endPoint = { (float)x, y + 0.5f }; break; //left
-                    }
-                    allSegments.push_back({ startPoint, endPoint });
-                }
+                std::cerr << "Error: can't load image" << std::endl;
+                job.finished = true;
+                return;
+            }
+            job.mask = std::make_shared<const Mask>(thresholdImage(image, options.downsampleFactor));
+            ImageLoader::freeImageData(image);
+            if (options.maskCache.enabled)
+            {
+                MaskCache::storeMask(job.maskKey, job.mask);
             }
         }
-        return allSegments;
+        job.fileBytes = List<unsigned char>{};
     }
-    void printChainsToConsole(List<Math::Chain>& chains, int imageWidth, int imageHeight, int consoleWidth)
+
+    void extractStage(ImageJob& job, const Options& options, Executor* pool)
     {
-        if (chains.empty())
+        if (job.finished || job.extracted || abandonIfCancelled(job))
         {
-            std::cout << "Nessuna catena da visualizzare." << std::endl;
             return;
         }
-
-        int consoleHeight = static_cast<int>((static_cast<float>(imageHeight) / imageWidth) * consoleWidth * 0.5f);
-
-        std::vector<std::string> canvas(consoleHeight, std::string(consoleWidth, '.'));
-
-        char drawChar = 'A';
-
-        for (const auto& chain : chains)
+        job.chains = extractChains(*job.mask, options, pool, job.cancel);
+        if (abandonIfCancelled(job))
         {
-            for (const auto& point : chain)
-            {
-                int x = static_cast<int>((point.x / imageWidth) * consoleWidth);
-                int y = static_cast<int>((point.y / imageHeight) * consoleHeight);
+            return;
+        }
+        commitExtracted(job, options);
+    }
 
-                if (x >= 0 && x < consoleWidth && y >= 0 && y < consoleHeight)
-                {
-                    canvas[y][x] = drawChar;
-                }
-            }
-            drawChar++;
-            if (drawChar > 'Z') drawChar = 'A';
+    void simplifyStage(ImageJob& job, const Options& options, Executor* pool)
+    {
+        if (job.finished)
+        {
+            return;
+        }
+        if (!simplifiesWhileTracing(options))
+        {
+            simplifyChains(job.chains, options.tolerance, options.simplify, job.mask ? splitPool(*job.mask, options, pool) : nullptr, job.cancel);
+        }
+        if (!isCancelled(job.cancel))
+        {
+            applyVertexBudget(job.chains, options.simplify.maxVerticesPerChain, options.simplify.maxVerticesPerImage);
         }
+        if (abandonIfCancelled(job))
+        {
+            return;
+        }
+        commitSimplified(job, options);
+    }
 
-        std::cout << "\n--- Visualizzazione Contorni Semplificati ---" << std::endl;
-        for (int i = 0; i < consoleHeight; ++i)
+    void commitExtracted(ImageJob& job, const Options& options)
+    {
+        job.extracted = true;
+        if (keepsRawChains(options))
         {
-            std::cout << canvas[i] << std::endl;
+            MaskCache::storeRawChains(job.maskKey, std::make_shared<const List<Math::Chain>>(job.chains));
         }
-        std::cout << "---------------------------------------------\n" << std::endl;
     }
-    List<Math::Chain> vectorizeImage(std::string path, float tolerance)
+
+    void commitSimplified(ImageJob& job, const Options& options)
     {
-        ImageData image = ImageLoader::loadImageData(path);
-        if (!image.isValid())
+        if (job.hasResultKey)
         {
-            std::cerr << "Error: can't load image" << std::endl;
-            return List<Math::Chain>{};
+            ResultCache::store(options.cache, job.resultKey, job.chains);
         }
+        job.mask = nullptr;
+        job.finished = true;
+    }
+
+    List<Math::Chain> vectorizeJob(ImageJob& job, const Options& options, Executor* pool)
+    {
+        decodeStage(job, options);
+        extractStage(job, options, pool);
+        simplifyStage(job, options, pool);
+        return std::move(job.chains);
+    }
+
+    List<Math::Chain> vectorizeFile(const std::string& path, const Options& options, Executor* pool)
+    {
+        ImageJob job;
+        job.path = path;
+        return vectorizeJob(job, options, pool);
+    }
+
+    List<Math::Chain> vectorizeImage(std::string path, float tolerance)
+    {
+        Options options;
+        options.tolerance = tolerance;
+        return vectorizeImage(path, options);
+    }
 
-        List<Math::Segment> rawSegments = Vectorizer::marchingSquares(image);
+    List<Math::Chain> vectorizeImage(const std::string& path, const Options& options, Executor* executor)
+    {
+        return vectorizeFile(path, options, executor);
+    }
 
-        List<Math::Chain> chains = Vectorizer::buildChainsFromSegments(rawSegments);
+    List<Math::Chain> vectorizeImage(const ImageView& image, const Options& options, Executor* executor)
+    {
+        return vectorizeView(image, options, executor);
+    }
 
-        for (Math::Chain& chain : chains)
+    static List<Contour> toContours(List<Math::Chain> chains)
+    {
+        List<Contour> contours(chains.size());
+        for (size_t i = 0; i < chains.size(); ++i)
         {
-            Vectorizer::simplifyChain(chain, tolerance);
+            contours[i].closed = isClosed(chains[i]);
+            if (contours[i].closed)
+            {
+                chains[i].pop_back();
+            }
+            contours[i].points = std::move(chains[i]);
         }
-        return chains;
+        nestContours(contours);
+        return contours;
+    }
+
+    List<Contour> vectorizeContours(const std::string& path, const Options& options, Executor* executor)
+    {
+        return toContours(vectorizeFile(path, options, executor));
+    }
+
+    List<Contour> vectorizeContours(const ImageView& image, const Options& options, Executor* executor)
+    {
+        return toContours(vectorizeView(image, options, executor));
+    }
+
+    CacheStats getResultCacheStats()
+    {
+        return ResultCache::stats();
+    }
+
+    void setMaskCacheBudget(size_t bytes)
+    {
+        MaskCache::setBudget(bytes);
+    }
+
+    void clearMaskCache()
+    {
+        MaskCache::clear();
+    }
+
+    CacheStats getMaskCacheStats()
+    {
+        return MaskCache::stats();
     }
-}
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdint>
+#include "Core/IndexedHeap.h"
+#include "Core/Simplify.h"
+
+namespace Vectorizer
+{
+    void applyVertexBudget(List<Math::Chain>& chains, size_t maxPerChain, size_t maxTotal)
+    {
+        const size_t perChainLimit = maxPerChain ? maxPerChain : SIZE_MAX;
+        const size_t totalLimit = maxTotal ? maxTotal : SIZE_MAX;
+
+        // Every vertex of every chain gets a global id; closed chains drop their repeated
+        // closing vertex and are treated as rings.
+        List<size_t> offsets(chains.size() + 1, 0);
+        List<bool> loops(chains.size());
+        for (size_t c = 0; c < chains.size(); ++c)
+        {
+            loops[c] = isClosed(chains[c]) && chains[c].size() >= 4;
+            offsets[c + 1] = offsets[c] + chains[c].size() - (loops[c] ? 1 : 0);
+        }
+        const size_t vertexCount = offsets.back();
+
+        List<size_t> counts(chains.size());
+        size_t total = 0;
+        size_t chainsOverLimit = 0;
+        for (size_t c = 0; c < chains.size(); ++c)
+        {
+            counts[c] = offsets[c + 1] - offsets[c];
+            total += counts[c];
+            chainsOverLimit += counts[c] > perChainLimit ? 1 : 0;
+        }
+        if (total <= totalLimit && chainsOverLimit == 0)
+        {
+            return;
+        }
+
+        List<size_t> chainOf(vertexCount), previous(vertexCount), next(vertexCount);
+        for (size_t c = 0; c < chains.size(); ++c)
+        {
+            const size_t begin = offsets[c], count = counts[c];
+            for (size_t i = 0; i < count; ++i)
+            {
+                chainOf[begin + i] = c;
+                previous[begin + i] = begin + (i + count - 1) % count;
+                next[begin + i] = begin + (i + 1) % count;
+            }
+        }
+        auto point = [&](size_t vertex) -> const Math::Point& {
+            return chains[chainOf[vertex]][vertex - offsets[chainOf[vertex]]];
+        };
+        auto area = [&](size_t vertex) {
+            return Math::triangleArea(point(previous[vertex]), point(vertex), point(next[vertex]));
+        };
+
+        // A vertex's importance is the triangle it spans with its neighbours, as in
+        // Visvalingam-Whyatt. Open chains keep their endpoints.
+        IndexedHeap<4> heap(vertexCount);
+        for (size_t c = 0; c < chains.size(); ++c)
+        {
+            if (counts[c] < 3)
+            {
+                continue;
+            }
+            const size_t first = loops[c] ? offsets[c] : offsets[c] + 1;
+            const size_t last = loops[c] ? offsets[c + 1] : offsets[c + 1] - 1;
+            for (size_t vertex = first; vertex < last; ++vertex)
+            {
+                heap.push(vertex, area(vertex));
+            }
+        }
+
+        List<bool> removed(vertexCount, false);
+        while (!heap.empty() && (total > totalLimit || chainsOverLimit > 0))
+        {
+            const size_t vertex = heap.top();
+            const float removedArea = heap.topKey();
+            heap.pop();
+
+            // Chains already within their own limit only give vertices up to the total budget.
+            const size_t c = chainOf[vertex];
+            const size_t minimum = loops[c] ? 3 : 2;
+            if (counts[c] <= minimum || (counts[c] <= perChainLimit && total <= totalLimit))
+            {
+                continue;
+            }
+            removed[vertex] = true;
+            counts[c]--;
+            total--;
+            if (counts[c] == perChainLimit)
+            {
+                chainsOverLimit--;
+            }
+
+            const size_t before = previous[vertex], after = next[vertex];
+            next[before] = after;
+            previous[after] = before;
+            if (heap.contains(before))
+            {
+                heap.update(before, std::max(area(before), removedArea));
+            }
+            if (heap.contains(after))
+            {
+                heap.update(after, std::max(area(after), removedArea));
+            }
+        }
+
+        for (size_t c = 0; c < chains.size(); ++c)
+        {
+            Math::Chain kept;
+            kept.reserve(counts[c] + 1);
+            for (size_t vertex = offsets[c]; vertex < offsets[c + 1]; ++vertex)
+            {
+                if (!removed[vertex])
+                {
+                    kept.push_back(point(vertex));
+                }
+            }
+            if (loops[c])
+            {
+                kept.push_back(kept.front());
+            }
+            chains[c] = std::move(kept);
+        }
+    }
+}
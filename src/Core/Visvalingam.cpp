@@ -0,0 +1,82 @@
+#include <algorithm>
+#include "Core/IndexedHeap.h"
+#include "Core/Simplify.h"
+
+namespace Vectorizer
+{
+    static constexpr size_t removalsPerCancelCheck = 1024;
+
+    void simplifyVisvalingam(Math::Chain& chain, float tolerance, bool closedLoops, const CancelFlag* cancel)
+    {
+        const bool loop = closedLoops && isClosed(chain) && chain.size() >= 4;
+        const size_t count = loop ? chain.size() - 1 : chain.size(); // loops drop the repeated vertex
+        const size_t minimum = loop ? 3 : 2;
+        if (count <= minimum)
+        {
+            return;
+        }
+
+        // Surviving vertices form a doubly linked list; open chains keep both endpoints.
+        List<size_t> previous(count), next(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            previous[i] = (i + count - 1) % count;
+            next[i] = (i + 1) % count;
+        }
+        auto area = [&](size_t i) {
+            return Math::triangleArea(chain[previous[i]], chain[i], chain[next[i]]);
+        };
+        IndexedHeap<4> heap(count);
+        const size_t first = loop ? 0 : 1;
+        const size_t last = loop ? count : count - 1;
+        for (size_t i = first; i < last; ++i)
+        {
+            heap.push(i, area(i));
+        }
+
+        const float threshold = tolerance * tolerance;
+        List<bool> removed(count, false);
+        size_t remaining = count;
+        size_t removals = 0;
+        while (!heap.empty() && remaining > minimum && heap.topKey() < threshold)
+        {
+            if (++removals % removalsPerCancelCheck == 0 && isCancelled(cancel))
+            {
+                return;
+            }
+            const size_t vertex = heap.top();
+            const float removedArea = heap.topKey();
+            heap.pop();
+            removed[vertex] = true;
+            remaining--;
+
+            const size_t before = previous[vertex], after = next[vertex];
+            next[before] = after;
+            previous[after] = before;
+            // Effective areas never fall below the one just removed, keeping the order monotonic.
+            if (heap.contains(before))
+            {
+                heap.update(before, std::max(area(before), removedArea));
+            }
+            if (heap.contains(after))
+            {
+                heap.update(after, std::max(area(after), removedArea));
+            }
+        }
+
+        Math::Chain simplified;
+        simplified.reserve(remaining + 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!removed[i])
+            {
+                simplified.push_back(chain[i]);
+            }
+        }
+        if (loop)
+        {
+            simplified.push_back(simplified.front());
+        }
+        chain = std::move(simplified);
+    }
+}
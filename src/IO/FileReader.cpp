@@ -0,0 +1,415 @@
+#include <algorithm>
+#include "Core/Parallel.h"
+#include "ImageLoader.h"
+#include "FileReader.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VEC_HAS_PREAD 1
+#endif
+
+#if defined(VEC_USE_IO_URING) && defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+static List<unsigned char> preadFile(const std::string& path)
+{
+#if defined(VEC_HAS_PREAD)
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		return {};
+	}
+	struct stat info;
+	List<unsigned char> bytes;
+	if (fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		bytes.resize(static_cast<size_t>(info.st_size));
+		size_t offset = 0;
+		while (offset < bytes.size())
+		{
+			ssize_t count = pread(fd, bytes.data() + offset, bytes.size() - offset, static_cast<off_t>(offset));
+			if (count <= 0)
+			{
+				break;
+			}
+			offset += static_cast<size_t>(count);
+		}
+		bytes.resize(offset);
+	}
+	close(fd);
+	return bytes;
+#else
+	return ImageLoader::readFile(path);
+#endif
+}
+
+#if defined(VEC_USE_IO_URING) && defined(__linux__)
+namespace
+{
+	// Minimal single-threaded io_uring wrapper over the raw syscalls, so liburing isn't needed.
+	class Ring
+	{
+	public:
+		~Ring()
+		{
+			if (sqesPointer != MAP_FAILED) munmap(sqesPointer, sqesSize);
+			if (cqPointer != MAP_FAILED && cqPointer != sqPointer) munmap(cqPointer, cqSize);
+			if (sqPointer != MAP_FAILED) munmap(sqPointer, sqSize);
+			if (fd >= 0) close(fd);
+		}
+
+		bool init(unsigned depth)
+		{
+			io_uring_params params;
+			std::memset(&params, 0, sizeof(params));
+			fd = static_cast<int>(syscall(__NR_io_uring_setup, depth, &params));
+			if (fd < 0)
+			{
+				return false;
+			}
+			entries = params.sq_entries;
+
+			sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+			cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (singleMap)
+			{
+				sqSize = cqSize = std::max(sqSize, cqSize);
+			}
+			sqPointer = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+			if (sqPointer == MAP_FAILED)
+			{
+				return false;
+			}
+			cqPointer = singleMap ? sqPointer : mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+			if (cqPointer == MAP_FAILED)
+			{
+				return false;
+			}
+			sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+			sqesPointer = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+			if (sqesPointer == MAP_FAILED)
+			{
+				return false;
+			}
+
+			char* sq = static_cast<char*>(sqPointer);
+			sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+			sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+			sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+			sqes = static_cast<io_uring_sqe*>(sqesPointer);
+
+			char* cq = static_cast<char*>(cqPointer);
+			cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+			cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+			cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+			cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+			return true;
+		}
+
+		unsigned capacity() const { return entries; }
+
+		io_uring_sqe& nextSqe()
+		{
+			unsigned index = localTail & sqMask;
+			io_uring_sqe& sqe = sqes[index];
+			std::memset(&sqe, 0, sizeof(sqe));
+			sqArray[index] = index;
+			localTail++;
+			pendingSubmit++;
+			return sqe;
+		}
+
+		bool submitAndWait(unsigned waitCount)
+		{
+			__atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+			while (true)
+			{
+				long result = syscall(__NR_io_uring_enter, fd, pendingSubmit, waitCount, IORING_ENTER_GETEVENTS, nullptr, 0);
+				if (result >= 0)
+				{
+					pendingSubmit -= static_cast<unsigned>(result);
+					return true;
+				}
+				if (errno != EINTR)
+				{
+					return false;
+				}
+			}
+		}
+
+		// Waits for a completion without submitting anything; the ring stays usable after the
+		// transient errors a full completion queue can cause.
+		bool waitForCompletion()
+		{
+			while (true)
+			{
+				long result = syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+				if (result >= 0)
+				{
+					return true;
+				}
+				if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+				{
+					return false;
+				}
+			}
+		}
+
+		unsigned unsubmitted() const { return pendingSubmit; }
+
+		template<typename Handler>
+		void reap(Handler&& handler)
+		{
+			unsigned head = *cqHead;
+			unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+			for (; head != tail; ++head)
+			{
+				const io_uring_cqe& cqe = cqes[head & cqMask];
+				handler(cqe.user_data, cqe.res);
+			}
+			__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+		}
+
+	private:
+		int fd = -1;
+		unsigned entries = 0;
+		void* sqPointer = MAP_FAILED;
+		void* cqPointer = MAP_FAILED;
+		void* sqesPointer = MAP_FAILED;
+		size_t sqSize = 0, cqSize = 0, sqesSize = 0;
+		unsigned* sqTail = nullptr;
+		unsigned* sqArray = nullptr;
+		unsigned sqMask = 0;
+		unsigned localTail = 0;
+		unsigned pendingSubmit = 0;
+		io_uring_sqe* sqes = nullptr;
+		unsigned* cqHead = nullptr;
+		unsigned* cqTail = nullptr;
+		unsigned cqMask = 0;
+		io_uring_cqe* cqes = nullptr;
+	};
+
+	enum class Operation : unsigned { Open = 0, Read = 1 };
+
+	struct PendingFile {
+		int fd = -1;
+		size_t offset = 0;
+		bool failed = false;
+		bool useFallback = false;
+	};
+
+	// Rings are per thread because a ring's submission queue has a single producer.
+	static thread_local unique<Ring> threadLocalRing;
+	static thread_local unsigned threadLocalRingDepth = 0;
+
+	Ring* threadRing(unsigned depth)
+	{
+		if (!threadLocalRing || threadLocalRingDepth < depth)
+		{
+			threadLocalRing = std::make_unique<Ring>();
+			threadLocalRingDepth = depth;
+			if (!threadLocalRing->init(depth))
+			{
+				threadLocalRing.reset();
+				threadLocalRingDepth = 0;
+			}
+		}
+		return threadLocalRing.get();
+	}
+
+	bool readWithRing(Ring& ring, const List<std::string>& paths, unsigned queueDepth, List<List<unsigned char>>& out)
+	{
+		const unsigned depth = std::max(1u, std::min(queueDepth, ring.capacity()));
+		List<PendingFile> files(paths.size());
+		List<size_t> readReady;
+		size_t nextOpen = 0;
+		unsigned inFlight = 0;
+
+		auto userData = [](size_t index, Operation operation) {
+			return (static_cast<std::uint64_t>(index) << 1) | static_cast<std::uint64_t>(operation);
+		};
+		auto finish = [&](size_t index, bool failed) {
+			PendingFile& file = files[index];
+			if (file.fd >= 0)
+			{
+				close(file.fd);
+				file.fd = -1;
+			}
+			file.failed = failed;
+			if (failed)
+			{
+				out[index].clear();
+			}
+			else
+			{
+				out[index].resize(file.offset);
+			}
+		};
+
+		// An open that completes while the batch is being abandoned still hands out a descriptor.
+		auto closeLateOpen = [](std::uint64_t data, int result) {
+			if (static_cast<Operation>(data & 1) == Operation::Open && result >= 0)
+			{
+				close(result);
+			}
+		};
+
+		while (nextOpen < paths.size() || !readReady.empty() || inFlight > 0)
+		{
+			// Reads go first so the number of open descriptors stays near the queue depth.
+			while (inFlight < depth && !readReady.empty())
+			{
+				size_t index = readReady.back();
+				readReady.pop_back();
+				PendingFile& file = files[index];
+				io_uring_sqe& sqe = ring.nextSqe();
+				sqe.opcode = IORING_OP_READ;
+				sqe.fd = file.fd;
+				sqe.addr = reinterpret_cast<std::uint64_t>(out[index].data() + file.offset);
+				sqe.len = static_cast<unsigned>(std::min<size_t>(out[index].size() - file.offset, 1u << 30));
+				sqe.off = file.offset;
+				sqe.user_data = userData(index, Operation::Read);
+				inFlight++;
+			}
+			while (inFlight < depth && nextOpen < paths.size() && readReady.size() < depth)
+			{
+				io_uring_sqe& sqe = ring.nextSqe();
+				sqe.opcode = IORING_OP_OPENAT;
+				sqe.fd = AT_FDCWD;
+				sqe.addr = reinterpret_cast<std::uint64_t>(paths[nextOpen].c_str());
+				sqe.open_flags = O_RDONLY | O_CLOEXEC;
+				sqe.user_data = userData(nextOpen, Operation::Open);
+				nextOpen++;
+				inFlight++;
+			}
+
+			if (!ring.submitAndWait(1))
+			{
+				// Submitted requests still point at out and paths, so wait for all of them before
+				// the caller reuses the buffers. Requests the kernel never took can't run anymore.
+				ring.reap([&](std::uint64_t data, int result) {
+					inFlight--;
+					closeLateOpen(data, result);
+				});
+				while (inFlight > ring.unsubmitted() && ring.waitForCompletion())
+				{
+					ring.reap([&](std::uint64_t data, int result) {
+						inFlight--;
+						closeLateOpen(data, result);
+					});
+				}
+				for (PendingFile& file : files)
+				{
+					if (file.fd >= 0)
+					{
+						close(file.fd);
+					}
+				}
+				return false;
+			}
+			ring.reap([&](std::uint64_t data, int result) {
+				inFlight--;
+				size_t index = static_cast<size_t>(data >> 1);
+				PendingFile& file = files[index];
+				if (static_cast<Operation>(data & 1) == Operation::Open)
+				{
+					if (result == -EINVAL || result == -EOPNOTSUPP)
+					{
+						file.useFallback = true; // kernel without IORING_OP_OPENAT
+						return;
+					}
+					if (result < 0)
+					{
+						finish(index, true);
+						return;
+					}
+					file.fd = result;
+					struct stat info;
+					if (fstat(file.fd, &info) != 0 || info.st_size <= 0)
+					{
+						finish(index, true);
+						return;
+					}
+					out[index].resize(static_cast<size_t>(info.st_size));
+					readReady.push_back(index);
+					return;
+				}
+
+				if (result == -EAGAIN || result == -EINTR)
+				{
+					readReady.push_back(index);
+				}
+				else if (result < 0)
+				{
+					finish(index, true);
+				}
+				else if (result == 0)
+				{
+					finish(index, false); // file shrank while being read
+				}
+				else
+				{
+					file.offset += static_cast<size_t>(result);
+					if (file.offset < out[index].size())
+					{
+						readReady.push_back(index);
+					}
+					else
+					{
+						finish(index, false);
+					}
+				}
+			});
+		}
+
+		for (size_t i = 0; i < files.size(); ++i)
+		{
+			if (files[i].useFallback)
+			{
+				out[i] = preadFile(paths[i]);
+			}
+		}
+		return true;
+	}
+}
+#endif
+
+bool FileReader::ioUringAvailable()
+{
+#if defined(VEC_USE_IO_URING) && defined(__linux__)
+	return threadRing(1) != nullptr;
+#else
+	return false;
+#endif
+}
+
+List<List<unsigned char>> FileReader::readFiles(const List<std::string>& paths, unsigned queueDepth, Vectorizer::Executor* pool)
+{
+	List<List<unsigned char>> files(paths.size());
+#if defined(VEC_USE_IO_URING) && defined(__linux__)
+	if (Ring* ring = threadRing(std::max(1u, queueDepth)))
+	{
+		if (readWithRing(*ring, paths, queueDepth, files))
+		{
+			return files;
+		}
+		// readWithRing only gives up once none of its requests can still touch the buffers.
+		threadLocalRing.reset();
+		threadLocalRingDepth = 0;
+		files.assign(paths.size(), {});
+	}
+#endif
+	// Each pread blocks its task, so the pool keeps several reads going at once.
+	Vectorizer::parallelFor(pool, paths.size(), [&](size_t i) {
+		files[i] = preadFile(paths[i]);
+	});
+	return files;
+}
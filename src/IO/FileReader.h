@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include "Vectorizer/Executor.h"
+#include "Vectorizer/Util.h"
+
+namespace FileReader
+{
+	// Reads whole files with up to queueDepth requests in flight. On Linux builds with
+	// VEC_USE_IO_URING the opens and reads go through one io_uring per thread; otherwise,
+	// or when the kernel refuses the ring, the files are read with pread in parallel on the
+	// pool (one at a time on the calling thread when pool is null). A file that can't be read
+	// yields an empty buffer.
+	List<List<unsigned char>> readFiles(const List<std::string>& paths, unsigned queueDepth, Vectorizer::Executor* pool);
+
+	bool ioUringAvailable();
+}
@@ -1,3 +1,5 @@
+#include <filesystem>
+#include <fstream>
 #include "stb_image.h"
 #include "ImageLoader.h"
 
@@ -6,4 +8,34 @@ ImageData ImageLoader::loadImageData(const std::string& path)
 	int width, height, channels;
 	unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
 	return ImageData{ path, width, height, channels, data };
-}
\ No newline at end of file
+}
+
+ImageData ImageLoader::loadImageDataFromMemory(const std::string& path, const List<unsigned char>& fileBytes)
+{
+	int width, height, channels;
+	unsigned char* data = stbi_load_from_memory(fileBytes.data(), static_cast<int>(fileBytes.size()), &width, &height, &channels, 0);
+	return ImageData{ path, width, height, channels, data };
+}
+
+void ImageLoader::freeImageData(ImageData& image)
+{
+	stbi_image_free(const_cast<unsigned char*>(image.data));
+	image.data = nullptr;
+}
+
+List<unsigned char> ImageLoader::readFile(const std::string& path)
+{
+	std::error_code error;
+	std::uintmax_t size = std::filesystem::file_size(path, error);
+	std::ifstream file(path, std::ios::binary);
+	if (error || !file)
+	{
+		return {};
+	}
+	List<unsigned char> bytes(static_cast<size_t>(size));
+	if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(size)))
+	{
+		return {};
+	}
+	return bytes;
+}
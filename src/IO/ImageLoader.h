@@ -14,4 +14,8 @@ struct ImageData {
 namespace ImageLoader
 {
 	ImageData loadImageData(const std::string& path);
-}
\ No newline at end of file
+	ImageData loadImageDataFromMemory(const std::string& path, const List<unsigned char>& fileBytes);
+	void freeImageData(ImageData& image);
+
+	List<unsigned char> readFile(const std::string& path);
+}
@@ -27,5 +27,9 @@ namespace Vectorizer
             Point pProjection = segment.start + segmentVector * tClamped;
             return pointsDistance(p, pProjection);
         }
+        float triangleArea(Point a, Point b, Point c)
+        {
+            return std::fabs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) * 0.5f;
+        }
     }
 }